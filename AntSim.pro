@@ -40,29 +40,60 @@ TEMPLATE = app
 
 SOURCES += main.cpp\
         antsimmainwindow.cpp \
+    antsimbatch.cpp \
     world/graphicsworldtile.cpp \
     utils/antgraph.cpp \
+    utils/antpath.cpp \
+    utils/antthreadpool.cpp \
     ants/antbot.cpp \
-    world/graphicsantitem.cpp \
     ants/antpheromone.cpp \
-    world/graphicspheromoneitem.cpp \
+    ants/antpheromonefield.cpp \
+    ants/antstats.cpp \
+    ants/antsimulation.cpp \
+    world/graphicscache.cpp \
+    world/graphicssnapshotitem.cpp \
+    world/graphicsheatmapitem.cpp \
+    world/graphicsterrainitem.cpp \
     ants/antworldtile.cpp \
+    ants/antneighbours.cpp \
     utils/antposition.cpp \
+    utils/antgrid.cpp \
+    utils/antrandom.cpp \
     ants/antworld.cpp \
-    world/antworldscene.cpp
+    world/antworldscene.cpp \
+    headless/headlessantworld.cpp \
+    headless/headlessant.cpp \
+    headless/headlesspheromone.cpp \
+    headless/headlessworldtile.cpp
 
 HEADERS  += antsimmainwindow.h \
+    antsimbatch.h \
     world/graphicsworldtile.h \
     utils/antgraph.h \
+    utils/antpath.h \
+    utils/antthreadpool.h \
     ants/antbot.h \
-    world/graphicsantitem.h \
     utils/antconfig.h \
     ants/antpheromone.h \
-    world/graphicspheromoneitem.h \
+    ants/antpheromonefield.h \
+    ants/antstats.h \
+    ants/antsnapshot.h \
+    ants/antsimulation.h \
+    world/graphicscache.h \
+    world/graphicssnapshotitem.h \
+    world/graphicsheatmapitem.h \
+    world/graphicsterrainitem.h \
     ants/antworldtile.h \
+    ants/antneighbours.h \
     utils/antposition.h \
+    utils/antgrid.h \
+    utils/antrandom.h \
     ants/antworld.h \
-    world/antworldscene.h
+    world/antworldscene.h \
+    headless/headlessantworld.h \
+    headless/headlessant.h \
+    headless/headlesspheromone.h \
+    headless/headlessworldtile.h
 
 FORMS    += antsimmainwindow.ui
 
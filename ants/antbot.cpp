@@ -31,29 +31,29 @@
 #include "utils/antgraph.h"
 #include "utils/antconfig.h"
 
-#include <cstdlib>
 #include <climits>
-#include <numeric>
 #include <algorithm>
-#include <map>
 
 /*--------------------------------------------------------------------------------------*/
 
 AntBot::AntBot( const AntPosition& position )
-: m_graph                    ( new AntGraph( position ) ),
-  m_position                 ( position ),
-  m_state                    ( Foraging ),
-  m_pheromoneType            ( AntPheromone::None ),
-  m_droppedPheromone         ( false ),
-  m_doPheromoneDeregistration( false ),
-  m_neighbourPheromoneSum    ( 0.0 ),
-  m_pheromoneStrength        ( 0.0 ),
-  m_returningToSource        ( false ),
-  m_stepsFromTarget          ( 0 ),
-  m_shortestPathLength       ( INT_MAX ),
-  m_neighbours               (),
-  m_pheromones               (),
-  m_deRegisteredPheromones   () {}
+: m_graph                 ( new AntGraph( position ) ),
+  m_random                (),
+  m_position              ( position ),
+  m_state                 ( Foraging ),
+  m_graphicsUpdates       ( 0 ),
+  m_stateCounters         ( nullptr ),
+  m_pheromoneType         ( AntPheromone::None ),
+  m_droppedPheromone      ( false ),
+  m_neighbourPheromoneSum ( 0.0 ),
+  m_pheromoneStrength     ( 0.0 ),
+  m_returningToSource     ( false ),
+  m_stepsFromTarget       ( 0 ),
+  m_shortestPathLength    ( INT_MAX ),
+  m_returnStep            (),
+  m_neighbours            (),
+  m_neighbourCount        ( 0 ),
+  m_pheromones            () {}
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -64,10 +64,29 @@ AntBot::~AntBot()
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntBot::advance()
+void AntBot::reset( const AntPosition& position )
 {
-  m_doPheromoneDeregistration = false;
+  m_graph->reset( position );
+  m_state = Foraging;
+  m_graphicsUpdates = StateChanged;
+  m_stateCounters = nullptr;
+  m_pheromoneType = AntPheromone::None;
+  m_droppedPheromone = false;
+  m_neighbourPheromoneSum = 0.0;
+  m_pheromoneStrength = 0.0;
+  m_returningToSource = false;
+  m_stepsFromTarget = 0;
+  m_shortestPathLength = INT_MAX;
+  m_returnStep = AntPath::const_iterator();
+  m_pheromones.clear();
+
+  updatePosition( position );
+}
 
+/*--------------------------------------------------------------------------------------*/
+
+void AntBot::advance()
+{
   /* Ant states turn to "DroppingPheromone" as soon as they have found the food source for
    * the first time.  This enables them to continue dropping pheromone on the tiles leading
    * to the food source, but also to "restart" the foraging experience (so that they do not
@@ -97,16 +116,40 @@ const AntPosition& AntBot::position() const
 
 void AntBot::setAntState( AntBot::AntState state )
 {
+  if( m_stateCounters && stateCounter( state ) != stateCounter( m_state ) )
+  {
+    m_stateCounters->move( stateCounter( m_state ), stateCounter( state ) );
+  }
+
   m_state = state;
+  m_graphicsUpdates |= StateChanged;
+}
 
-  switch( m_state )
+/*--------------------------------------------------------------------------------------*/
+
+void AntBot::flushGraphics()
+{
+  if( m_graphicsUpdates & PositionChanged )
   {
-    case Gathering:
-      showFoundGraphics();
-      break;
-    default:
-      showForageGraphics();
+    updateGraphics( m_position );
   }
+
+  if( m_graphicsUpdates & StateChanged )
+  {
+    switch( m_state )
+    {
+      case Gathering:
+        showFoundGraphics();
+        break;
+      case Dead:
+        showDeadGraphics();
+        break;
+      default:
+        showForageGraphics();
+    }
+  }
+
+  m_graphicsUpdates = 0;
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -118,6 +161,38 @@ void AntBot::setMaxNodesRemembered( unsigned int maxNodesRemembered )
 
 /*--------------------------------------------------------------------------------------*/
 
+void AntBot::setStateCounters( AntStateCounters* counters )
+{
+  m_stateCounters = counters;
+  if( m_stateCounters ) m_stateCounters->add( stateCounter( m_state ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntStateCounters::Counter AntBot::stateCounter( AntState state )
+{
+  switch( state )
+  {
+    case Gathering:           // deliberate fall-through
+    case DroppingPheromone:
+      return AntStateCounters::Gathering;
+    case Dead:
+      return AntStateCounters::Dead;
+    case Foraging:
+    default:
+      return AntStateCounters::Foraging;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntBot::setRandomStream( std::uint64_t seed, std::uint64_t stream )
+{
+  m_random.seed( seed, stream );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
 bool AntBot::droppedPheromone() const
 {
   bool temp = m_droppedPheromone;
@@ -141,26 +216,27 @@ double AntBot::droppedPheromoneStrength() const
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntBot::registerPheromonePosition( const AntPosition& pheromonePosition )
+void AntBot::registerPheromonePosition( const AntPosition& pheromonePosition, unsigned int serial )
 {
-  if( std::none_of( std::begin( m_pheromones ), std::end( m_pheromones ),
-                    [ &pheromonePosition ]( AntPosition pos ){ return pos == pheromonePosition; } ) )
+  auto registered = std::find_if( std::begin( m_pheromones ), std::end( m_pheromones ),
+                                  [ &pheromonePosition ]( const PheromoneRef& ref ){ return ref.position == pheromonePosition; } );
+
+  if( registered == std::end( m_pheromones ) )
   {
-    m_pheromones.push_back( pheromonePosition );
+    PheromoneRef ref = { pheromonePosition, serial };
+    m_pheromones.push_back( ref );
+  }
+  else
+  {
+    registered->serial = serial;
   }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-const std::vector< AntPosition >& AntBot::deRegisteredPheromonePositions()
+const std::vector< AntBot::PheromoneRef >& AntBot::registeredPheromones() const
 {
-  if( !m_deRegisteredPheromones.empty() &&
-      !m_doPheromoneDeregistration )
-  {
-    m_deRegisteredPheromones.clear();
-  }
-
-  return m_deRegisteredPheromones;
+  return m_pheromones;
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -172,7 +248,7 @@ int AntBot::stepsFromTarget() const
 
 /*--------------------------------------------------------------------------------------*/
 
-const std::vector< AntPosition >& AntBot::shortestPath() const
+const AntPath& AntBot::shortestPath() const
 {
   return m_graph->shortestPath();
 }
@@ -200,17 +276,23 @@ bool AntBot::isGathering() const
 
 /*--------------------------------------------------------------------------------------*/
 
+bool AntBot::isReturning() const
+{
+  return m_state == Gathering;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
 void AntBot::updatePosition( const AntPosition& position )
 {
   m_position = position;
 
-  /* In case the query always returns neighbours in a specific order, e.g. N, E, S, W,
-    add another touch of randomised variation to the entire procedure. */
-  m_neighbours.clear();
-  m_neighbours = queryTerrain( m_position );
-  std::random_shuffle( std::begin( m_neighbours ), std::end( m_neighbours ) );
+  /* Copy the neighbours out of the (non-owning) view. */
+  AntNeighbours neighbours = queryTerrain( m_position );
+  m_neighbourCount = neighbours.size();
+  for( int i = 0; i < m_neighbourCount; ++i ) m_neighbours[ i ] = neighbours.at( i );
 
-  updateGraphics( m_position );
+  m_graphicsUpdates |= PositionChanged;
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -219,53 +301,52 @@ const AntPosition& AntBot::determineNextPosition()
 {
   /* If, for whatever reason, a tile has no neighbours (you never know how the world
    * might be constructed), return the current position. */
-  if( m_neighbours.size() == 0 ) return m_position;
-
-  std::vector< int > probabilities = calculateNeighbourProbabilities();
+  if( m_neighbourCount == 0 ) return m_position;
 
-  /* Calculate the normalisation factor (sum of probabilities must ultimately add to 1.0). */
-  double normalisationFactor = static_cast< double >( AntConfig::ProbabilityRange ) /
-                               std::accumulate( probabilities.begin(), probabilities.end(), 0 );
+  /* Everything below lives on the stack since a tile never has more than
+   * AntNeighbours::MaxNeighbours neighbours. */
+  std::array< double, AntNeighbours::MaxNeighbours > strengths;
+  m_neighbourPheromoneSum = 0.0;
 
-  /* Now we calculate the normalised probabilities for each tile and stick these normalised values
-   * into a map against their original, pre-sorted indices (otherwise we will not know which index
-   * went with which tile initially). */
-  std::multimap< int /*value*/, int /*index*/ > indices;
-
-  for( std::vector< int >::size_type i = 0; i < probabilities.size(); ++i )
+  for( int i = 0; i < m_neighbourCount; ++i )
   {
-    probabilities[ i ] = static_cast< int >( probabilities[ i ] * normalisationFactor );
-    indices.insert( std::make_pair( probabilities[ i ], i ) );
+    strengths[ i ] = m_neighbours[ i ]->tilePheromoneStrength();
+    m_neighbourPheromoneSum += strengths[ i ];
   }
 
-  /* Sort the values from lowest to highest, randomly select a value in the
-   * probability range and see in which interval the selected probability falls. */
-  std::sort( probabilities.begin(), probabilities.end() );
-  int selectedProbability = rand() % AntConfig::ProbabilityRange + 1;   // don't want to select 0 prob (disallowed) tiles
+  /* Without any pheromone to go by (every weight below would be 0/0), fall back to giving
+   * all neighbours the same weight, i.e. a uniform choice among the passable tiles. */
+  if( !( m_neighbourPheromoneSum > 0.0 ) )
+  {
+    strengths.fill( 1.0 );
+    m_neighbourPheromoneSum = m_neighbourCount;
+  }
 
-  std::vector< int >::size_type index = 0;
+  /* Lay the tiles' selection weights out end to end on a "roulette wheel" (each tile
+   * occupies a slice proportional to its weight), then spin the wheel once. */
+  std::array< int, AntNeighbours::MaxNeighbours > wheel;
+  int total = 0;
 
-  while( index < probabilities.size() - 1 )
+  for( int i = 0; i < m_neighbourCount; ++i )
   {
-    if( selectedProbability > probabilities[ index ] )
-    {
-      ++index;
-    }
-    else
-    {
-      break;
-    }
+    total += calculateTileProbabilityMax( m_neighbours[ i ], strengths[ i ] );
+    wheel[ i ] = total;
   }
 
-  /* Use the convenience mapping to obtain the index of the tile associated with the
-   * selected probability and use that index (remember the indices of "probabilities"
-   * correspond to those of m_neighbours) to find the selected tile's centre position. */
-  return m_neighbours[ ( indices.find( probabilities[ index ] ) )->second ]->centre();
+  /* Surrounded by walls and hazards, stay put. */
+  if( total == 0 ) return m_position;
+
+  int selected = m_random.bounded( total );
+  int index = 0;
+
+  while( selected >= wheel[ index ] ) ++index;   // zero-weight tiles have empty slices and are never selected
+
+  return m_neighbours[ index ]->centre();
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-int AntBot::calculateTileProbabilityMax( const AntWorldTile* tile ) const
+int AntBot::calculateTileProbabilityMax( const AntWorldTile* tile, double pheromoneStrength )
 {
   /* Skip all tiles where ants have gone...and died...shame...*/
   if( tile->tilePheromoneType() == AntPheromone::Hazard ) return 0;
@@ -280,8 +361,8 @@ int AntBot::calculateTileProbabilityMax( const AntWorldTile* tile ) const
         double finalRange = AntConfig::ProbabilityRange;
         if( m_graph->recentlyVisited( tile->centre() ) ) finalRange /= AntConfig::RecentlyVisitedPenalty;
 
-        double probabilityMax = ( tile->tilePheromoneStrength() / m_neighbourPheromoneSum ) * finalRange;
-        if( probabilityMax < 1.0 ) probabilityMax = rand() % static_cast< int >( finalRange ) + 1;  // +1 since we can't return 0 values for non-wall/non-hazard tiles
+        double probabilityMax = ( pheromoneStrength / m_neighbourPheromoneSum ) * finalRange;
+        if( probabilityMax < 1.0 ) probabilityMax = m_random.bounded( static_cast< int >( finalRange ) ) + 1;  // +1 since we can't return 0 values for non-wall/non-hazard tiles
 
         return static_cast< int >( probabilityMax );
       }
@@ -296,54 +377,20 @@ int AntBot::calculateTileProbabilityMax( const AntWorldTile* tile ) const
 
 /*--------------------------------------------------------------------------------------*/
 
-std::vector< int > AntBot::calculateNeighbourProbabilities()
+void AntBot::forage()
 {
-  m_neighbourPheromoneSum = std::accumulate( std::begin( m_neighbours ), std::end( m_neighbours ), 0.0,
-                                             []( double sum, const AntWorldTile*& tile ) { return sum + tile->tilePheromoneStrength(); } );
-
-  /* First we determine the selection probability maximum for each tile. The indices
-   * of the probability maximums will coincide with the indices of their respective
-   * tiles in m_neighbours. */
-  std::vector< int > probabilities;
-  for( auto& neighbour : m_neighbours ) probabilities.push_back( calculateTileProbabilityMax( neighbour ) );
+  /* If any of the neighbouring tiles is a food or hazard tile, we're done.  In case the
+   * query always returns neighbours in a specific order, e.g. N, E, S, W, start looking
+   * at a random neighbour (so that neither food nor hazards are favoured when both are
+   * adjacent). The selection itself does not depend on the order of the neighbours. */
+  int first = ( m_neighbourCount > 1 ) ? m_random.bounded( m_neighbourCount ) : 0;
 
-  /* Introduce a "shake" factor to distinguish duplicate values from each other. The range is
-   * a bit of an arbitrary calculation since the value must be relatively small compared to
-   * the entire probability range, yet cannot be fixed in case the parameters change. */
-  int shakeRange = AntConfig::ProbabilityRange / AntConfig::RecentlyVisitedPenalty;
-
-  for( auto probability : probabilities )
+  for( int i = 0; i < m_neighbourCount; ++i )
   {
-    /* We don't want to shake 0 values since these must remain 0 (Walls and Hazards should
-     * definitely not be traversable). */
-    if( probability > 0 )
-    {
-      /* Check if we have duplicates. */
-      if( std::count( std::begin( probabilities ), std::end( probabilities ), probability ) > 1 )
-      {
-        /* Find the duplicates of this specific probability and apply the shake
-          factor to all of them. */
-        auto it = std::find( std::begin( probabilities ), std::end( probabilities ), probability );
-
-        while( it != std::end( probabilities ) )
-        {
-          *it += rand() % shakeRange;
-          it = std::find( it + 1, std::end( probabilities ), probability );
-        }
-      }
-    }
+    const AntWorldTile* tile = m_neighbours[ ( first + i ) % m_neighbourCount ];
+    if( foundFood( tile ) || encounteredHazard( tile ) ) return;
   }
 
-  return probabilities;
-}
-
-/*--------------------------------------------------------------------------------------*/
-
-void AntBot::forage()
-{
-  /* If any of the neighbouring tiles is a food or hazard tile, we're done. */
-  for( auto& tile : m_neighbours ) if( foundFood( tile ) || encounteredHazard( tile ) ) return;
-
   auto position = determineNextPosition();
   updatePosition( position );
   m_graph->addNode( position );  // "addNode" automatically checks for duplicates
@@ -357,8 +404,8 @@ void AntBot::gather()
   {
     if( m_stepsFromTarget < m_shortestPathLength )
     {
-      auto position = m_graph->shortestPath()[ m_stepsFromTarget ];
-      updatePosition( position );
+      --m_returnStep;
+      updatePosition( *m_returnStep );
       ++m_stepsFromTarget;
     }
     else
@@ -385,7 +432,7 @@ bool AntBot::foundFood( const AntWorldTile* tile )
 
     /* See if the new source/target path is shorter than the previous before we
      * change the state, etc to avoid switching to a worse solution. */
-    int newShortestPathLength = static_cast< int >( m_graph->shortestPath().size() );
+    int newShortestPathLength = m_graph->shortestPath().size();
 
     if( m_shortestPathLength > newShortestPathLength )
     {
@@ -394,10 +441,8 @@ bool AntBot::foundFood( const AntWorldTile* tile )
       m_pheromoneStrength = ( 1.0 / static_cast< double >( m_shortestPathLength ) );
       m_pheromoneType = AntPheromone::Found;
       m_returningToSource = true;
-      m_deRegisteredPheromones.clear();
-      m_deRegisteredPheromones = m_pheromones;
-      m_pheromones.clear();
-      m_doPheromoneDeregistration = true;
+      m_returnStep = m_graph->shortestPath().end();
+      m_pheromones.clear();   // stop contributing to the previous path's pheromones
       return true;
     }
   }
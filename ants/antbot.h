@@ -30,8 +30,13 @@
 #define ANTBOT_H
 
 #include "antpheromone.h"
+#include "antneighbours.h"
+#include "antstats.h"
 #include "utils/antposition.h"
+#include "utils/antrandom.h"
+#include "utils/antpath.h"
 #include <vector>
+#include <array>
 #include <memory>
 
 /*--------------------------------------------------------------------------------------*/
@@ -53,6 +58,7 @@ class AntWorldTile;
  *  \sa updateGraphics
  *  \sa showFoundGraphics
  *  \sa showForageGraphics
+ *  \sa showDeadGraphics
  */
 
 class AntBot
@@ -61,9 +67,29 @@ public:
   /*! Destructor. */
   virtual ~AntBot();
 
-  /*! Advances the ant to the next best node. */
+  /*! Returns the ant to the state it was constructed in at "position", keeping the memory
+   *  it has allocated so far (its graph, paths and pheromone list).  AntWorld uses this to
+   *  reuse dead ants rather than creating new ones, see AntWorld::registerAnt.  The ant
+   *  no longer counts itself anywhere (see setStateCounters).
+   *
+   *  \sa isDead */
+  void reset( const AntPosition& position );
+
+  /*! Advances the ant to the next best node.  Other than reading its surroundings (tile
+   *  types and pheromone strengths), this function only touches the ant's own state and
+   *  defers all graphics updates to flushGraphics, i.e. ants can advance concurrently
+   *  provided their world doesn't change while they do.
+   *
+   *  \sa flushGraphics */
   void advance();
 
+  /*! Applies the graphics updates (position and/or state changes) accumulated since the last
+   *  call by calling updateGraphics, showFoundGraphics or showForageGraphics as needed.
+   *  Call this function from the thread that owns the graphics.
+   *
+   *  \sa advance */
+  void flushGraphics();
+
   /*! Returns the ant's position relative to its world. */
   const AntPosition& position() const;
 
@@ -91,28 +117,38 @@ public:
    */
   double droppedPheromoneStrength() const;
 
+  /*! A pheromone the ant contributes to, identified by its position and the serial number it
+   *  had when it was registered (see AntPheromoneField::serial).  Should the pheromone be
+   *  removed, a pheromone dropped on the same tile later on has a different serial number,
+   *  i.e. the reference no longer matches and the ant stops contributing to it. */
+  struct PheromoneRef
+  {
+    AntPosition position;
+    unsigned int serial;
+  };
+
   /*! Ants need to know which pheromones they are contributing to on each iteration (in other
    *  words, all pheromones registered with an ant will receive a pheromone update on each
    *  iteration).  When the ant's shortest path changes, the old pheromones are "forgotten" and
-   *  a new list is started.
+   *  a new list is started.  Registering a position again updates its serial number.
    *
-   *  \sa deRegisteredPheromonePositions
+   *  \sa registeredPheromones
    */
-  void registerPheromonePosition( const AntPosition& pheromonePosition );
+  void registerPheromonePosition( const AntPosition& pheromonePosition, unsigned int serial );
 
-  /*! Returns the pheromones from which this particular ant must be deregistered (returns
-   *  and empty vector if no pheromones are tagged for deregistration).
+  /*! Returns the pheromones this ant is currently contributing to (i.e. those that should
+   *  receive its droppedPheromoneStrength on each iteration if they are still there).
    *
-   *  \sa registerPheromone
+   *  \sa registerPheromonePosition
    */
-  const std::vector< AntPosition >& deRegisteredPheromonePositions();
+  const std::vector< PheromoneRef >& registeredPheromones() const;
 
   /*! Returns the number of steps that the ant's current position is from the target
    *  (returns INT_MAX when the ant is foraging/dead). */
   int stepsFromTarget() const;
 
-  /*! Returns the ant's internal shortest path or an empty vector if the ant is still foraging. */
-  const std::vector< AntPosition >& shortestPath() const;
+  /*! Returns the ant's internal shortest path (source to target) or an empty path if the ant is still foraging. */
+  const AntPath& shortestPath() const;
 
   /*! Returns "true' if the ant is foraging (hasn't found the target yet). */
   bool isForaging() const;
@@ -123,19 +159,32 @@ public:
   /*! Returns "true" if ant is gathering (returning to source from target or having found food). */
   bool isGathering() const;
 
+  /*! Returns "true" if the ant is returning to source from target (unlike isGathering, this
+   *  excludes ants that have found food before but are foraging again). */
+  bool isReturning() const;
+
   /*! Tells the ant's internal graph to keep track of of "x" nr of last nodes visited. */
   void setMaxNodesRemembered( unsigned int maxNodesRemembered);
 
+  /*! Makes the ant count itself in "counters" and keep them up to date as its state changes
+   *  (AntWorld passes its counters to every ant it registers, see AntWorld::stats). */
+  void setStateCounters( AntStateCounters* counters );
+
+  /*! Restarts the ant's random number generator at "stream" of "seed".  Every ant draws
+   *  from its own stream so that runs are reproducible for a given seed (AntWorld assigns
+   *  the streams, see AntWorld::setSeed). */
+  void setRandomStream( std::uint64_t seed, std::uint64_t stream );
+
 protected:
   /*! Constructor. */
   explicit AntBot( const AntPosition& position );
 
-  /*! Implement this function to return a list of AntWorldTiles neighbouring the
-   *  ant's current "position".
+  /*! Implement this function to return a view of the AntWorldTiles neighbouring the
+   *  ant's current "position" (typically AntWorld::neighbours).
    *
    *  \sa update
    */
-  virtual std::vector< const AntWorldTile* > queryTerrain( const AntPosition& position ) = 0;
+  virtual AntNeighbours queryTerrain( const AntPosition& position ) = 0;
 
   /*! Implement this function to update the graphics with the new position (in other words,
    *  this function should move the ant's graphical representation to "position").
@@ -158,8 +207,16 @@ protected:
    */
   virtual void showForageGraphics() = 0;
 
+  /*! Implement this function to hide the ant's graphical representation once it has died
+   *  (dead ants are kept around for reuse, after which showForageGraphics is called).
+   *
+   *  \sa reset
+   */
+  virtual void showDeadGraphics() = 0;
+
   /*! Updates the ant's position and determines the new position's neighbours
-   *  before advancing the ant to the new position.
+   *  before advancing the ant to the new position (the graphics follow on the next
+   *  flushGraphics).
    *
    *  \sa queryTerrain
    *  \sa updateGraphics
@@ -167,21 +224,18 @@ protected:
   void updatePosition( const AntPosition& position );
 
 private:
-  /*! Returns the next position chosen.
+  /*! Returns the next position chosen by roulette-wheel selection amongst the neighbouring
+   *  tiles (each tile is selected with a probability proportional to its weight as
+   *  calculated by calculateTileProbabilityMax).  Returns the current position if none of
+   *  the neighbours can be moved to.
    *
    *  \sa calculateTileProbabilityMax
-   *  \sa calculateNeighbourProbabilities
    */
   const AntPosition& determineNextPosition();
 
-  /*! Returns a vector of the all the neighbouring tiles' probability of selection.
-   *
-   *  \sa determineNextPosition
-   */
-  std::vector< int > calculateNeighbourProbabilities();
-
-  /*! Calculates and returns the maximum probability that "tile" will be selected based
-   *  on the Ant System probability equation and AntSim's probability heuristics.
+  /*! Calculates and returns the maximum probability (the selection weight) that "tile", with
+   *  pheromone strength "pheromoneStrength", will be selected based on the Ant System
+   *  probability equation and AntSim's probability heuristics.
    *
    *  See:
    *
@@ -199,7 +253,7 @@ private:
    *
    *  /sa determineNextPosition
   */
-  int calculateTileProbabilityMax( const AntWorldTile* tile ) const;
+  int calculateTileProbabilityMax( const AntWorldTile* tile, double pheromoneStrength );
 
   /*! Keep looking for the target.
    *
@@ -235,10 +289,20 @@ private:
     DroppingPheromone /*!< Ant has found the food target (at least once) but is once again searching for additional routes. */
   };
 
-  /*! Sets the ant's state and calls showFoundGraphics and showForageGraphics
-   *  (in order to enforce user-defined graphics preferences). */
+  /*! Sets the ant's state and flags the ant for a call to showFoundGraphics or showForageGraphics
+   *  (in order to enforce user-defined graphics preferences) on the next flushGraphics. */
   void setAntState( AntState state );
 
+  /*! Returns the counter corresponding to "state" (gathering ants include those dropping pheromone). */
+  static AntStateCounters::Counter stateCounter( AntState state );
+
+  /*! Graphics updates pending until the next flushGraphics. */
+  enum GraphicsUpdate
+  {
+    PositionChanged = 0x1,
+    StateChanged    = 0x2
+  };
+
 private:
   /*! AntBots are not copyable. */
   AntBot( const AntBot& ) = delete;
@@ -247,12 +311,14 @@ private:
   AntBot& operator=( const AntBot& ) = delete;
 
   std::unique_ptr< AntGraph > m_graph;
+  AntRandom m_random;
   AntPosition m_position;
   AntState m_state;
+  unsigned int m_graphicsUpdates;   // GraphicsUpdate flags
+  AntStateCounters* m_stateCounters;
 
   AntPheromone::PheromoneType m_pheromoneType;
   mutable bool m_droppedPheromone;
-  bool m_doPheromoneDeregistration;
 
   double m_neighbourPheromoneSum;
   double m_pheromoneStrength;
@@ -260,10 +326,11 @@ private:
   bool m_returningToSource;
   int m_stepsFromTarget;
   int m_shortestPathLength;
+  AntPath::const_iterator m_returnStep;   // the shortest path is walked backwards from target to source
 
-  std::vector< const AntWorldTile* > m_neighbours;
-  std::vector< AntPosition > m_pheromones;               // keep track of registered pheromones
-  std::vector< AntPosition > m_deRegisteredPheromones;   // keep track of deregistered pheromones
+  std::array< const AntWorldTile*, AntNeighbours::MaxNeighbours > m_neighbours;
+  int m_neighbourCount;
+  std::vector< PheromoneRef > m_pheromones;   // keep track of registered pheromones
 };
 
 #endif // ANTBOT_H
\ No newline at end of file
@@ -26,40 +26,41 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#include "graphicspheromoneitem.h"
-#include "utils/antconfig.h"
-#include <QPen>
+#include "antneighbours.h"
 
 /*--------------------------------------------------------------------------------------*/
 
-GraphicsPheromoneItem::GraphicsPheromoneItem( const AntPosition& position, PheromoneType type, QGraphicsItem* parent )
-: AntPheromone( position, type ),
-  QGraphicsEllipseItem( parent ),
-  m_opacity( 1.0 )
+const int AntNeighbours::MaxNeighbours;
+
+/*--------------------------------------------------------------------------------------*/
+
+AntNeighbours::AntNeighbours()
+: m_indices( nullptr ),
+  m_tiles  ( nullptr ),
+  m_size   ( 0 ) {}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntNeighbours::AntNeighbours( const int* indices, AntWorldTile* const* tiles )
+: m_indices( indices ),
+  m_tiles  ( tiles ),
+  m_size   ( 0 )
 {
-  setPen( QPen( Qt::darkGray ) );
-  setRect( position.x() - AntConfig::PheromoneSize / 2, position.y() - AntConfig::PheromoneSize / 2, AntConfig::PheromoneSize, AntConfig::PheromoneSize );
+  while( m_size < MaxNeighbours && m_indices[ m_size ] >= 0 ) ++m_size;
+}
+
+/*--------------------------------------------------------------------------------------*/
 
-  switch( type )
-  {
-    case Found:
-      setBrush( Qt::darkGreen );
-      break;
-    case Hazard:
-      setBrush( Qt::darkRed );
-      break;
-    case None:
-    default:
-      setBrush( Qt::white );
-  }
+int AntNeighbours::size() const
+{
+  return m_size;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsPheromoneItem::updateGraphics()
+const AntWorldTile* AntNeighbours::at( int i ) const
 {
-  m_opacity = qreal( pheromoneStrength() );
-  setOpacity( m_opacity );
+  return m_tiles[ m_indices[ i ] ];
 }
 
-/*--------------------------------------------------------------------------------------*/
\ No newline at end of file
+/*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,73 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTNEIGHBOURS_H
+#define ANTNEIGHBOURS_H
+
+/*--------------------------------------------------------------------------------------*/
+
+class AntWorldTile;
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief A light-weight, non-owning view of the (up to four) world tiles adjacent to a tile.
+ *
+ *  AntWorld precomputes a neighbour table holding four tile indices per tile and hands out
+ *  views onto it, so querying a tile's neighbours involves neither searching nor allocation.
+ *
+ *  \warning A view is only valid until the next world tile is registered (the underlying
+ *  table may be re-allocated), copy the tiles out if they need to outlive that.
+ */
+
+class AntNeighbours
+{
+public:
+  /*! The maximum number of neighbours any tile can have in the 2D grid. */
+  static const int MaxNeighbours = 4;
+
+  /*! Constructs an empty view (i.e. a tile without any neighbours). */
+  AntNeighbours();
+
+  /*! Constructs a view onto the "MaxNeighbours" entries starting at "indices" (unused
+   *  entries are negative and trail the valid ones), "tiles" is the tile registry
+   *  the indices refer to. */
+  AntNeighbours( const int* indices, AntWorldTile* const* tiles );
+
+  /*! Returns the number of neighbouring tiles. */
+  int size() const;
+
+  /*! Returns the neighbouring tile at "i" ( 0 <= i < size() ). */
+  const AntWorldTile* at( int i ) const;
+
+private:
+  const int* m_indices;
+  AntWorldTile* const* m_tiles;
+  int m_size;
+};
+
+#endif // ANTNEIGHBOURS_H
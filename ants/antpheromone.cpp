@@ -27,18 +27,14 @@
  */
 
 #include "antpheromone.h"
-#include "antbot.h"
-#include "utils/antconfig.h"
-#include <algorithm>
+#include "antpheromonefield.h"
 
 /*--------------------------------------------------------------------------------------*/
 
-AntPheromone::AntPheromone( const AntPosition& position, PheromoneType type )
-: m_type           ( type ),
-  m_position       ( position ),
-  m_strength       ( 1.0 ),
-  m_evaporationRate( 0.0 ),
-  m_ants           () {}
+AntPheromone::AntPheromone( const AntPosition& position )
+: m_position( position ),
+  m_field   ( nullptr ),
+  m_index   ( 0 ) {}
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -48,73 +44,36 @@ AntPheromone::~AntPheromone() {}
 
 void AntPheromone::update()
 {
-  m_ants.erase( std::remove_if( std::begin( m_ants ), std::end( m_ants ),
-                                []( WeakAntPtr& ant ){ return ant.expired(); } ),
-                std::end( m_ants ) );
-
   updateGraphics();
-
-  /* Hazards will remain active for the duration of the run and will not evaporate. */
-  if( m_type == Hazard )
-  {
-    m_strength = 1.0;
-  }
-  else
-  {
-    auto antPheromoneSum( 0.0 );
-
-    for( auto& ant : m_ants )
-    {
-      SharedAntPtr bot = ant.lock();
-      if( bot ) antPheromoneSum += bot->droppedPheromoneStrength();
-    }
-
-    m_strength = ( 1.0 - m_evaporationRate ) * m_strength + antPheromoneSum;
-  }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-double AntPheromone::pheromoneStrength() const
+void AntPheromone::attach( AntPheromoneField* field, int index )
 {
-  return evaporated() ? 0.0 : m_strength;
+  m_field = field;
+  m_index = index;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntPheromone::setEvaporationRate( double evaporationRate )
-{
-  m_evaporationRate = evaporationRate;
-}
-
-/*--------------------------------------------------------------------------------------*/
-
-bool AntPheromone::evaporated() const
+double AntPheromone::pheromoneStrength() const
 {
-  return m_strength < AntConfig::PheromoneMin;
+  return evaporated() ? 0.0 : m_field->strength( m_index );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntPheromone::registerAnt( SharedAntPtr ant )
+void AntPheromone::setEvaporationRate( double evaporationRate )
 {
-  for( auto& bot : m_ants ) if( bot.lock() == ant ) return;
-  m_ants.push_back( ant );
+  if( m_field ) m_field->setEvaporationRate( m_index, evaporationRate );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntPheromone::deRegisterAnt( const SharedAntPtr &ant )
+bool AntPheromone::evaporated() const
 {
-  auto count( -1 );
-
-  for( auto& bot : m_ants )
-  {
-    count++;
-    if( bot.lock() == ant ) break;
-  }
-
-  if( count >= 0 ) m_ants.erase( std::begin( m_ants ) + count );
+  return !m_field || m_field->evaporated( m_index );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -128,14 +87,14 @@ const AntPosition& AntPheromone::position() const
 
 AntPheromone::PheromoneType AntPheromone::pheromoneType() const
 {
-  return m_type;
+  return m_field ? m_field->type( m_index ) : None;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntPheromone::setPheromoneType( AntPheromone::PheromoneType type )
 {
-  m_type = type;
+  if( m_field ) m_field->setType( m_index, type );
 }
 
 /*--------------------------------------------------------------------------------------*/
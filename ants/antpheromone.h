@@ -30,12 +30,10 @@
 #define ANTPHEROMONE_H
 
 #include "utils/antposition.h"
-#include <vector>
-#include <memory>
 
 /*--------------------------------------------------------------------------------------*/
 
-class AntBot;
+class AntPheromoneField;
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -45,13 +43,14 @@ class AntBot;
  *  As an abstract base class, users must therefore ensure that they inherit from it and
  *  implement \sa updateGraphics in order to apply graphical effects associated with pheromone state
  *  and type.
+ *
+ *  The pheromone's state (type, strength and evaporation rate) is kept in the world's
+ *  AntPheromoneField, which the pheromone is attached to when it is registered.
  */
 
 class AntPheromone
 {
 public:
-  using SharedAntPtr = std::shared_ptr< const AntBot >;
-
   enum PheromoneType
   {
     Found,    /*!< Pheromone is on a path leading to the target. */
@@ -62,9 +61,14 @@ public:
   /*! Destructor. */
   virtual ~AntPheromone();
 
-  /*! Updates the pheromone state (evaporation counters, graphics, etc).*/
+  /*! Updates the pheromone's graphics (the pheromone state itself is updated as part of the
+   *  field it is attached to, see AntPheromoneField::evaporate). */
   void update();
 
+  /*! Attaches the pheromone to the tile at "index" in "field" (called by AntWorld when the
+   *  pheromone is registered).  An unattached pheromone has type "None" and strength 0.0. */
+  void attach( AntPheromoneField* field, int index );
+
   /*! Returns the pheromone's type.
    *
    *  \sa setPheromoneType */
@@ -93,29 +97,12 @@ public:
    *  \sa pheromoneStrength */
   bool evaporated() const;
 
-  /*! Adds an ant reference for use when updating this pheromone's strength.  According to
-   *  the ACO algorithm, pheromone evaporation and addition is dependent on the number of
-   *  ants with a specific pheromone on their path and also the path length of the individual
-   *  ants in question.  Since the pheromone strength is dependent on the ants' internal shortest
-   *  paths, pheromones need to know which ants are dropping pheromone on them (hence the necessity
-   *  of maintaining a registry). This function won't add the ant if it is already known.
-   *
-   *  \sa deRegisterAnt */
-  void registerAnt( SharedAntPtr ant );
-
-  /*! When an ant is no longer contributing to a specific pheromone (e.g. when they have found
-   *  a shorter path), it needs to be removed from the pheromone's ant registry (to ensure that
-   *  they no longer influence the pheromone strength calculation).
-   *
-   *  \sa registerAnt */
-  void deRegisterAnt( const SharedAntPtr& ant );
-
   /*! Returns the pheromone's position. */
   const AntPosition& position() const;
 
 protected:
-  /*! Constructs a pheromone at "position" of "type". */
-  explicit AntPheromone( const AntPosition& position, PheromoneType type );
+  /*! Constructs a pheromone at "position". */
+  explicit AntPheromone( const AntPosition& position );
 
   /*! Re-implement for unique graphics associated with pheromone state and type. */
   virtual void updateGraphics() = 0;
@@ -128,13 +115,9 @@ private:
   AntPheromone& operator=( const AntPheromone& ) = delete;
 
 private:
-  PheromoneType m_type;
   AntPosition m_position;
-  double m_strength;
-  double m_evaporationRate;
-
-  using WeakAntPtr = std::weak_ptr< const AntBot >;
-  std::vector< WeakAntPtr > m_ants;   // keep track of ants with this pheromone on their path
+  AntPheromoneField* m_field;
+  int m_index;
 };
 
 #endif // ANTPHEROMONE_H
\ No newline at end of file
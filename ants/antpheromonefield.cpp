@@ -0,0 +1,422 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antpheromonefield.h"
+#include "utils/antconfig.h"
+
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define ANTPHEROMONEFIELD_SSE2
+#endif
+
+/*--------------------------------------------------------------------------------------*/
+
+const int AntPheromoneField::WheelSlots;
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPheromoneField::AntPheromoneField()
+: m_strength       (),
+  m_deposit        (),
+  m_evaporationRate(),
+  m_type           (),
+  m_serial         (),
+  m_lastSerial     ( 0 ),
+  m_lazy           ( false ),
+  m_rate           ( 0.0 ),
+  m_tick           ( 0 ),
+  m_lastUpdate     (),
+  m_expiry         (),
+  m_powers         ( 1, 1.0 ),
+  m_wheel          ( WheelSlots ),
+  m_due            (),
+  m_expired        () {}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::clear()
+{
+  m_strength.clear();
+  m_deposit.clear();
+  m_evaporationRate.clear();
+  m_type.clear();
+  m_serial.clear();
+  m_lastUpdate.clear();
+  m_expiry.clear();
+  m_expired.clear();
+
+  for( auto& slot : m_wheel ) slot.clear();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::addTile()
+{
+  m_strength.push_back( 0.0 );
+  m_deposit.push_back( 0.0 );
+  m_evaporationRate.push_back( 0.0 );
+  m_type.push_back( AntPheromone::None );
+  m_serial.push_back( 0 );
+  m_lastUpdate.push_back( m_tick );
+  m_expiry.push_back( -1 );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntPheromoneField::size() const
+{
+  return static_cast< int >( m_type.size() );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::addPheromone( int index, AntPheromone::PheromoneType type, double evaporationRate )
+{
+  m_strength[ index ] = 1.0;
+  m_deposit[ index ] = 0.0;
+  m_evaporationRate[ index ] = evaporationRate;
+  m_type[ index ] = AntPheromone::None;
+  m_lastUpdate[ index ] = m_tick;
+  setType( index, type );
+
+  /* Skip 0 (no pheromone) when the serial numbers wrap around. */
+  if( ++m_lastSerial == 0 ) ++m_lastSerial;
+  m_serial[ index ] = m_lastSerial;
+
+  if( m_lazy && type != AntPheromone::Hazard ) schedule( index );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::removePheromone( int index )
+{
+  m_strength[ index ] = 0.0;
+  m_deposit[ index ] = 0.0;
+  m_type[ index ] = AntPheromone::None;
+  m_serial[ index ] = 0;
+  m_expiry[ index ] = -1;   // the wheel skips entries that no longer match
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::removePheromones()
+{
+  m_strength.assign( m_strength.size(), 0.0 );
+  m_deposit.assign( m_deposit.size(), 0.0 );
+  m_type.assign( m_type.size(), AntPheromone::None );
+  m_serial.assign( m_serial.size(), 0 );
+  m_expiry.assign( m_expiry.size(), -1 );
+  m_expired.clear();
+
+  for( auto& slot : m_wheel ) slot.clear();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+unsigned int AntPheromoneField::serial( int index ) const
+{
+  return m_serial[ index ];
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntPheromoneField::containsPheromone( int index ) const
+{
+  return m_type[ index ] != AntPheromone::None;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPheromone::PheromoneType AntPheromoneField::type( int index ) const
+{
+  return static_cast< AntPheromone::PheromoneType >( m_type[ index ] );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::setType( int index, AntPheromone::PheromoneType type )
+{
+  /* Hazards will remain active for the duration of the run and will not evaporate (a zero
+   * evaporation rate keeps them at full strength without special-casing the kernel). */
+  if( type == AntPheromone::Hazard )
+  {
+    m_strength[ index ] = 1.0;
+    m_deposit[ index ] = 0.0;
+    m_evaporationRate[ index ] = 0.0;
+    m_expiry[ index ] = -1;
+  }
+
+  m_type[ index ] = static_cast< unsigned char >( type );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+double AntPheromoneField::strength( int index ) const
+{
+  if( m_lazy && m_type[ index ] != AntPheromone::Hazard ) return decayedStrength( index );
+  return m_strength[ index ];
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntPheromoneField::evaporated( int index ) const
+{
+  return strength( index ) < AntConfig::PheromoneMin;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::setEvaporationRate( int index, double evaporationRate )
+{
+  if( m_type[ index ] != AntPheromone::Hazard ) m_evaporationRate[ index ] = evaporationRate;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::setEvaporationRate( double evaporationRate )
+{
+  /* The strengths are only valid along with the rate they are decaying at. */
+  if( m_lazy ) for( int i = 0; i < size(); ++i ) refresh( i );
+
+  for( int i = 0; i < size(); ++i ) setEvaporationRate( i, evaporationRate );
+  m_rate = evaporationRate;
+  reschedule();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::deposit( int index, double strength )
+{
+  if( m_type[ index ] != AntPheromone::None &&
+      m_type[ index ] != AntPheromone::Hazard )
+  {
+    if( m_lazy )
+    {
+      /* Apply the coming tick's evaporation on the first deposit (as the eager pass would
+       * before adding the deposits) so that further deposits can simply be added. */
+      if( m_lastUpdate[ index ] != m_tick + 1 )
+      {
+        m_strength[ index ] = ( 1.0 - m_rate ) * decayedStrength( index );
+        m_lastUpdate[ index ] = m_tick + 1;
+      }
+
+      m_strength[ index ] += strength;
+    }
+    else
+    {
+      m_deposit[ index ] += strength;
+    }
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::evaporate()
+{
+  if( !m_lazy )
+  {
+    evaporate( 0, size() );
+    return;
+  }
+
+  ++m_tick;
+  m_expired.clear();
+
+  /* Deposits only ever add strength, so a pheromone that is due may have been topped up in
+   * the meantime, in which case it is simply scheduled again. */
+  std::vector< Expiry >& slot = m_wheel[ m_tick & ( WheelSlots - 1 ) ];
+  m_due.clear();
+  m_due.swap( slot );
+
+  for( const Expiry& expiry : m_due )
+  {
+    if( expiry.tick != m_tick )
+    {
+      slot.push_back( expiry );   // due on a later turn of the wheel
+    }
+    else if( m_expiry[ expiry.index ] == expiry.tick )
+    {
+      m_expiry[ expiry.index ] = -1;
+
+      if( decayedStrength( expiry.index ) < AntConfig::PheromoneMin )
+      {
+        refresh( expiry.index );
+        m_expired.push_back( expiry.index );
+      }
+      else
+      {
+        schedule( expiry.index );
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::evaporate( int begin, int end )
+{
+  if( m_lazy ) return;
+
+  double* strength = m_strength.data();
+  double* deposit = m_deposit.data();
+  const double* rate = m_evaporationRate.data();
+  const int count = end;
+  int i = begin;
+
+#ifdef ANTPHEROMONEFIELD_SSE2
+  /* Two tiles at a time.  Multiplication and addition are kept separate (rather than fused)
+   * so that the results are identical to those of the scalar loop below. */
+  const __m128d one = _mm_set1_pd( 1.0 );
+  const __m128d zero = _mm_setzero_pd();
+
+  for( ; i + 2 <= count; i += 2 )
+  {
+    __m128d retained = _mm_mul_pd( _mm_sub_pd( one, _mm_loadu_pd( rate + i ) ), _mm_loadu_pd( strength + i ) );
+    _mm_storeu_pd( strength + i, _mm_add_pd( retained, _mm_loadu_pd( deposit + i ) ) );
+    _mm_storeu_pd( deposit + i, zero );
+  }
+#endif
+
+  for( ; i < count; ++i )
+  {
+    strength[ i ] = ( 1.0 - rate[ i ] ) * strength[ i ] + deposit[ i ];
+    deposit[ i ] = 0.0;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::setLazyEvaporation( bool lazy )
+{
+  if( lazy != m_lazy )
+  {
+    if( m_lazy ) for( int i = 0; i < size(); ++i ) refresh( i );
+    m_lazy = lazy;
+    reschedule();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntPheromoneField::lazyEvaporation() const
+{
+  return m_lazy;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const std::vector< int >& AntPheromoneField::expiredPheromones() const
+{
+  return m_expired;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+double AntPheromoneField::decayedStrength( int index ) const
+{
+  /* Pheromones that don't evaporate are never scheduled, so the table only covers the ticks
+   * up to the latest expiry (beyond which the last power holds for a rate of 0.0). */
+  int elapsed = m_tick - m_lastUpdate[ index ];
+  if( elapsed <= 0 ) return m_strength[ index ];
+
+  int last = static_cast< int >( m_powers.size() ) - 1;
+  return m_strength[ index ] * m_powers[ std::min( elapsed, last ) ];
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::refresh( int index )
+{
+  if( m_type[ index ] != AntPheromone::Hazard )
+  {
+    m_strength[ index ] = decayedStrength( index );
+    m_lastUpdate[ index ] = m_tick;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::schedule( int index )
+{
+  if( m_rate <= 0.0 ) return;
+
+  const double strength = m_strength[ index ];
+
+  while( strength * m_powers.back() >= AntConfig::PheromoneMin )
+  {
+    m_powers.push_back( m_powers.back() * ( 1.0 - m_rate ) );
+  }
+
+  /* The first tick still to come at which the strength will have dropped below the minimum. */
+  int elapsed = std::max( 1, m_tick - m_lastUpdate[ index ] + 1 );
+  auto power = std::partition_point( m_powers.begin() + std::min( elapsed, static_cast< int >( m_powers.size() ) - 1 ),
+                                     m_powers.end(),
+                                     [ strength ]( double p ){ return strength * p >= AntConfig::PheromoneMin; } );
+
+  int tick = m_lastUpdate[ index ] + static_cast< int >( power - m_powers.begin() );
+  m_expiry[ index ] = tick;
+  m_wheel[ tick & ( WheelSlots - 1 ) ].push_back( Expiry{ index, tick } );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPheromoneField::reschedule()
+{
+  for( auto& slot : m_wheel ) slot.clear();
+  m_expiry.assign( m_expiry.size(), -1 );
+  m_expired.clear();
+  m_powers.assign( 1, 1.0 );
+
+  if( m_lazy )
+  {
+    /* The strengths are up to date at this point (see the callers). */
+    m_lastUpdate.assign( m_lastUpdate.size(), m_tick );
+
+    for( int i = 0; i < size(); ++i )
+    {
+      if( m_type[ i ] == AntPheromone::None ||
+          m_type[ i ] == AntPheromone::Hazard )
+      {
+        continue;
+      }
+
+      if( m_strength[ i ] < AntConfig::PheromoneMin )
+      {
+        m_expired.push_back( i );
+      }
+      else
+      {
+        schedule( i );
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,183 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTPHEROMONEFIELD_H
+#define ANTPHEROMONEFIELD_H
+
+#include "antpheromone.h"
+#include <vector>
+
+/*! \brief The state of all the pheromones in the world, stored as contiguous arrays with one
+ *  entry per world tile (indexed by the tiles' registration order).
+ *
+ *  AntPheromone objects and AntWorldTiles read their pheromone state from the field rather than
+ *  keeping their own, so that the per-tick evaporation step can be applied to the whole world
+ *  in a single vectorised pass (tiles without pheromone simply stay at strength 0.0).
+ *
+ *  Alternatively, the field can evaporate lazily (see setLazyEvaporation): rather than being
+ *  updated every tick, each strength is stored along with the tick at which it was last
+ *  brought up to date and the current strength is computed on read.  Expiry is scheduled in
+ *  a timing wheel so that the cost of a tick scales with the number of deposits rather than
+ *  with the number of pheromones in the world.
+ */
+
+class AntPheromoneField
+{
+public:
+  /*! Constructs an empty field (no tiles). */
+  AntPheromoneField();
+
+  /*! Removes all tiles from the field. */
+  void clear();
+
+  /*! Extends the field by a single tile without any pheromone on it. */
+  void addTile();
+
+  /*! Returns the number of tiles in the field. */
+  int size() const;
+
+  /*! Places a new pheromone of "type" (with strength 1.0) on the tile at "index". */
+  void addPheromone( int index, AntPheromone::PheromoneType type, double evaporationRate );
+
+  /*! Removes the pheromone from the tile at "index". */
+  void removePheromone( int index );
+
+  /*! Removes the pheromones from all tiles. */
+  void removePheromones();
+
+  /*! Returns the serial number of the pheromone on the tile at "index" (0 if there is none).
+   *  Every pheromone placed on the field gets a new one, so that a reference to a pheromone
+   *  that has since been removed can be told apart from one placed on the same tile later. */
+  unsigned int serial( int index ) const;
+
+  /*! Returns "true" if there is a (possibly evaporated) pheromone on the tile at "index". */
+  bool containsPheromone( int index ) const;
+
+  /*! Returns the type of the pheromone on the tile at "index" ("None" if there is none). */
+  AntPheromone::PheromoneType type( int index ) const;
+
+  /*! Changes the type of the pheromone on the tile at "index" ("Hazard" pheromones are
+   *  fixed at full strength, i.e. they neither evaporate nor receive deposits). */
+  void setType( int index, AntPheromone::PheromoneType type );
+
+  /*! Returns the strength of the pheromone on the tile at "index" (0.0 if there is none). */
+  double strength( int index ) const;
+
+  /*! Returns "true" if the strength of the pheromone on the tile at "index" has dropped
+   *  below AntConfig::PheromoneMin (also "true" if there is no pheromone). */
+  bool evaporated( int index ) const;
+
+  /*! Sets the evaporation rate of the pheromone on the tile at "index" (ignored when
+   *  evaporating lazily, in which case all pheromones share the field-wide rate). */
+  void setEvaporationRate( int index, double evaporationRate );
+
+  /*! Sets the evaporation rate of all pheromones in the field. */
+  void setEvaporationRate( double evaporationRate );
+
+  /*! Adds "strength" to the amount of pheromone deposited on the tile at "index" during the
+   *  current tick (ignored for "Hazard" pheromones and tiles without pheromone).
+   *
+   *  \sa evaporate */
+  void deposit( int index, double strength );
+
+  /*! Applies a tick's worth of evaporation and the deposits made since the last call,
+   *  i.e. strength = ( 1 - rate ) * strength + deposit, to every tile in the field.
+   *
+   *  \sa deposit */
+  void evaporate();
+
+  /*! As above, but only for the tiles at indices [ "begin", "end" ) (disjoint ranges can be
+   *  evaporated concurrently).  Does nothing when evaporating lazily.
+   *
+   *  \sa lazyEvaporation */
+  void evaporate( int begin, int end );
+
+  /*! Switches between evaporating every tile on each call to evaporate (default) and
+   *  evaporating lazily.  In the latter mode, a pheromone's strength is kept as it was when
+   *  last touched and read as strength * ( 1 - rate )^dt (where "dt" is the number of ticks
+   *  elapsed since, the powers being looked up from a table), deposits bring it up to date
+   *  before adding to it and evaporate merely advances the tick and collects the pheromones
+   *  that are due to drop below AntConfig::PheromoneMin (see expiredPheromones).
+   *
+   *  \sa lazyEvaporation */
+  void setLazyEvaporation( bool lazy );
+
+  /*! Returns "true" if the field evaporates lazily.
+   *
+   *  \sa setLazyEvaporation */
+  bool lazyEvaporation() const;
+
+  /*! Returns the indices of the tiles whose pheromones evaporated during the last call to
+   *  evaporate (lazy evaporation only, the list is always empty otherwise). */
+  const std::vector< int >& expiredPheromones() const;
+
+private:
+  /*! A pheromone scheduled to expire at "tick" (see m_wheel). */
+  struct Expiry
+  {
+    int index;
+    int tick;
+  };
+
+  /*! The number of slots in the timing wheel (a power of two). */
+  static const int WheelSlots = 256;
+
+  /*! Returns the strength of the (non-hazard) pheromone on the tile at "index" as of the
+   *  current tick (lazy evaporation). */
+  double decayedStrength( int index ) const;
+
+  /*! Stores the current strength of the pheromone on the tile at "index" (lazy evaporation). */
+  void refresh( int index );
+
+  /*! Schedules the expiry of the pheromone on the tile at "index" for the first tick at which
+   *  its strength will be below AntConfig::PheromoneMin (lazy evaporation). */
+  void schedule( int index );
+
+  /*! Brings all strengths up to date and, when evaporating lazily, rebuilds the power table
+   *  and the timing wheel (called when the mode or the field-wide rate changes). */
+  void reschedule();
+
+  std::vector< double > m_strength;
+  std::vector< double > m_deposit;
+  std::vector< double > m_evaporationRate;
+  std::vector< unsigned char > m_type;                  // AntPheromone::PheromoneType
+  std::vector< unsigned int > m_serial;                 // 0 if there is no pheromone
+  unsigned int m_lastSerial;
+
+  bool m_lazy;
+  double m_rate;                                        // field-wide evaporation rate
+  int m_tick;                                           // number of calls to evaporate so far
+  std::vector< int > m_lastUpdate;                      // tick as of which m_strength holds (lazy)
+  std::vector< int > m_expiry;                          // scheduled expiry tick, -1 if none (lazy)
+  std::vector< double > m_powers;                       // ( 1 - m_rate )^dt (lazy)
+  std::vector< std::vector< Expiry > > m_wheel;         // expiries, by tick modulo WheelSlots (lazy)
+  std::vector< Expiry > m_due;                          // the slot being processed
+  std::vector< int > m_expired;
+};
+
+#endif // ANTPHEROMONEFIELD_H
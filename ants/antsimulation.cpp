@@ -0,0 +1,251 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antsimulation.h"
+#include "antworld.h"
+
+#include <chrono>
+#include <climits>
+
+/*--------------------------------------------------------------------------------------*/
+
+AntSimulation::AntSimulation( AntWorld* world )
+: m_world        ( world ),
+  m_thread       (),
+  m_mutex        (),
+  m_wake         (),
+  m_running      ( false ),
+  m_interval     ( 0 ),
+  m_antCount     ( 0 ),
+  m_spawnPoints  (),
+  m_commands     (),
+  m_random       ( world->seed(), UINT64_MAX ),
+  m_tick         ( 0 ),
+  m_writing      (),
+  m_published    (),
+  m_snapshotTaken( true ) {}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntSimulation::~AntSimulation()
+{
+  stop();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::start()
+{
+  if( !m_thread.joinable() )
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_running = true;
+    }
+
+    m_thread = std::thread( &AntSimulation::run, this );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::stop()
+{
+  if( m_thread.joinable() )
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_running = false;
+    }
+
+    m_wake.notify_all();
+    m_thread.join();
+
+    /* The world is ours again, run whatever was posted after the last tick. */
+    std::vector< Command > commands;
+
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      commands.swap( m_commands );
+    }
+
+    for( auto& command : commands ) command( *m_world );
+
+    writeSnapshot();
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    publishSnapshot();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntSimulation::isRunning() const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  return m_running;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::setInterval( int milliseconds )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_interval = milliseconds;
+  }
+
+  m_wake.notify_all();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::setAntCount( int count )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  m_antCount = count;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::setSpawnPoints( const std::vector< AntPosition >& spawnPoints )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  m_spawnPoints = spawnPoints;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::post( const Command& command )
+{
+  std::unique_lock< std::mutex > lock( m_mutex );
+
+  if( m_running )
+  {
+    m_commands.push_back( command );
+  }
+  else
+  {
+    lock.unlock();
+    command( *m_world );
+    writeSnapshot();
+
+    lock.lock();
+    publishSnapshot();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntSimulation::takeSnapshot( AntSnapshot& snapshot )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( m_snapshotTaken ) return false;
+
+  std::swap( snapshot, m_published );
+  m_snapshotTaken = true;
+  return true;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::run()
+{
+  std::unique_lock< std::mutex > lock( m_mutex );
+  std::vector< Command > commands;
+  std::vector< AntPosition > spawnPoints;
+
+  while( m_running )
+  {
+    auto started = std::chrono::steady_clock::now();
+
+    /* Pick up everything the controlling thread has changed since the last tick, then let go
+     * of the lock for the duration of the tick. */
+    commands.swap( m_commands );
+    spawnPoints = m_spawnPoints;
+    int antCount = m_antCount;
+    bool snapshot = m_snapshotTaken;
+    lock.unlock();
+
+    for( auto& command : commands ) command( *m_world );
+    commands.clear();
+
+    spawn( antCount, spawnPoints );
+    m_world->tick();
+    ++m_tick;
+
+    if( snapshot ) writeSnapshot();
+
+    lock.lock();
+
+    if( snapshot ) publishSnapshot();
+
+    /* The interval may change (or the simulation may be stopped) while we wait. */
+    while( m_running &&
+           m_interval > 0 &&
+           std::chrono::steady_clock::now() < started + std::chrono::milliseconds( m_interval ) )
+    {
+      m_wake.wait_until( lock, started + std::chrono::milliseconds( m_interval ) );
+    }
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::spawn( int antCount, const std::vector< AntPosition >& spawnPoints )
+{
+  if( spawnPoints.empty() ) return;
+
+  AntStats stats = m_world->stats();
+
+  if( ( stats.ants + stats.dead ) < antCount )
+  {
+    /* Choose a random spawn point if there are more than one. */
+    int point = m_random.bounded( static_cast< int >( spawnPoints.size() ) );
+    m_world->registerAnt( spawnPoints.at( point ) );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::writeSnapshot()
+{
+  m_world->snapshot( m_writing );
+  m_writing.tick = m_tick;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimulation::publishSnapshot()
+{
+  std::swap( m_writing, m_published );
+  m_snapshotTaken = false;
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,141 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTSIMULATION_H
+#define ANTSIMULATION_H
+
+#include "antsnapshot.h"
+#include "utils/antposition.h"
+#include "utils/antrandom.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/*--------------------------------------------------------------------------------------*/
+
+class AntWorld;
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief Runs an AntWorld on a thread of its own, spawning ants and ticking the world at a
+ *  configurable rate, and publishes AntSnapshots of its state for display.
+ *
+ *  Snapshots are double buffered: the simulation thread fills one snapshot while the last one
+ *  it published waits to be taken (see takeSnapshot).  A new snapshot is only taken once the
+ *  previous one has been, so a display that only takes snapshots as often as it redraws never
+ *  holds the simulation up (it simply skips the ticks in between), and the simulation doesn't
+ *  spend time copying state that nobody will draw.
+ *
+ *  While the simulation is running, the world must not be touched other than through post.
+ */
+
+class AntSimulation
+{
+public:
+  /*! The function type of the commands run on the simulation thread (see post). */
+  using Command = std::function< void( AntWorld& ) >;
+
+  /*! Constructs a stopped simulation of "world" (which must outlive the simulation). */
+  explicit AntSimulation( AntWorld* world );
+
+  /*! Destructor (stops the simulation). */
+  ~AntSimulation();
+
+  /*! Starts (or continues) ticking the world on the simulation thread. */
+  void start();
+
+  /*! Stops ticking the world and returns once the simulation thread has finished its current
+   *  tick.  A snapshot of the world as it was left is published. */
+  void stop();
+
+  /*! Returns "true" while the simulation is running. */
+  bool isRunning() const;
+
+  /*! Sets the time between the starts of consecutive ticks (0, the default, ticks the world as
+   *  fast as possible). */
+  void setInterval( int milliseconds );
+
+  /*! Sets the number of ants to spawn (one per tick until the number of ants alive plus the
+   *  number of ants that have died reaches "count"). */
+  void setAntCount( int count );
+
+  /*! Sets the positions at which ants are spawned (one is chosen at random for every ant). */
+  void setSpawnPoints( const std::vector< AntPosition >& spawnPoints );
+
+  /*! Runs "command" on the world before the next tick (or immediately if the simulation isn't
+   *  running, in which case a new snapshot is published afterwards).  Commands are run in the
+   *  order in which they were posted and must not call back into the simulation. */
+  void post( const Command& command );
+
+  /*! Swaps the latest published snapshot into "snapshot" and returns "true" if there is one
+   *  that hasn't been taken yet, otherwise leaves "snapshot" alone and returns "false".  The
+   *  snapshot swapped out is reused by the simulation, so keep passing the same one. */
+  bool takeSnapshot( AntSnapshot& snapshot );
+
+private:
+  /*! AntSimulations are not copyable. */
+  AntSimulation( const AntSimulation& ) = delete;
+
+  /*! AntSimulations are not assignable. */
+  AntSimulation& operator=( const AntSimulation& ) = delete;
+
+  /*! The simulation thread's main loop. */
+  void run();
+
+  /*! Registers an ant at one of the spawn points if more ants are needed. */
+  void spawn( int antCount, const std::vector< AntPosition >& spawnPoints );
+
+  /*! Fills m_writing from the world (must be called by whichever thread owns the world). */
+  void writeSnapshot();
+
+  /*! Makes m_writing the published snapshot (call with m_mutex locked). */
+  void publishSnapshot();
+
+private:
+  AntWorld* m_world;
+  std::thread m_thread;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_wake;
+
+  bool m_running;
+  int m_interval;
+  int m_antCount;
+  std::vector< AntPosition > m_spawnPoints;
+  std::vector< Command > m_commands;                    // waiting for the next tick
+
+  AntRandom m_random;                                   // spawn point selection
+  std::uint64_t m_tick;
+  AntSnapshot m_writing;                                // owned by whichever thread owns the world
+  AntSnapshot m_published;
+  bool m_snapshotTaken;                                 // m_published has been taken
+};
+
+#endif // ANTSIMULATION_H
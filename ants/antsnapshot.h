@@ -0,0 +1,66 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTSNAPSHOT_H
+#define ANTSNAPSHOT_H
+
+#include "antpheromone.h"
+#include "antstats.h"
+#include "utils/antposition.h"
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief A copy of everything needed to draw the state of a world at the end of a given tick
+ *  (see AntWorld::snapshot), which can be read while the world itself moves on.
+ */
+
+struct AntSnapshot
+{
+  /*! An ant as it should be drawn. */
+  struct Ant
+  {
+    AntPosition position;
+    bool returning;                         /*!< The ant is carrying food back to its nest (see AntBot::isReturning). */
+  };
+
+  /*! A pheromone as it should be drawn. */
+  struct Pheromone
+  {
+    AntPosition position;
+    AntPheromone::PheromoneType type;
+    double strength;
+  };
+
+  std::uint64_t tick;                       /*!< The number of ticks completed (see AntSimulation). */
+  AntStats stats;
+  std::vector< Ant > ants;
+  std::vector< Pheromone > pheromones;
+};
+
+#endif // ANTSNAPSHOT_H
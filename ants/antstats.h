@@ -0,0 +1,89 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTSTATS_H
+#define ANTSTATS_H
+
+#include <array>
+#include <atomic>
+
+/*! \brief A snapshot of the colony statistics (see AntWorld::stats). */
+
+struct AntStats
+{
+  int ants;                 /*!< Ants currently alive. */
+  int foraging;             /*!< Ants still searching for the target. */
+  int gathering;            /*!< Ants that have found the target (at least once). */
+  int dead;                 /*!< Ants that have died since the ant register was last reset. */
+  int shortestPathLength;   /*!< The shortest known path length (INT_MAX while no target has been found). */
+};
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief Per-state ant counters that AntBots keep up to date whenever their state changes
+ *  (rather than the world recounting its ants on every tick).  Since ants may change state
+ *  while advancing concurrently, the counters are atomic.
+ */
+
+class AntStateCounters
+{
+public:
+  enum Counter
+  {
+    Foraging,
+    Gathering,
+    Dead,
+    Counters
+  };
+
+  /*! Constructs a set of counters that are all zero. */
+  AntStateCounters();
+
+  /*! Sets all counters back to zero. */
+  void reset();
+
+  /*! Increments "counter". */
+  void add( Counter counter );
+
+  /*! Decrements "from" and increments "to". */
+  void move( Counter from, Counter to );
+
+  /*! Returns the value of "counter". */
+  int value( Counter counter ) const;
+
+private:
+  /*! AntStateCounters are not copyable. */
+  AntStateCounters( const AntStateCounters& ) = delete;
+
+  /*! AntStateCounters are not assignable. */
+  AntStateCounters& operator=( const AntStateCounters& ) = delete;
+
+  std::array< std::atomic< int >, Counters > m_counters;
+};
+
+#endif // ANTSTATS_H
@@ -30,10 +30,18 @@
 #include "antbot.h"
 #include "antpheromone.h"
 #include "antworldtile.h"
+#include "utils/antconfig.h"
 
 #include <algorithm>
 #include <time.h>
 #include <climits>
+#include <cmath>
+#include <thread>
+
+/*--------------------------------------------------------------------------------------*/
+
+const int AntWorld::AntsPerTask;
+const int AntWorld::TilesPerTask;
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -56,20 +64,34 @@ void removeNullPointers( std::vector< T* >& vec )
 
 AntWorld::AntWorld()
 :
-  m_foragingAnts         ( 0 ),
-  m_gatheringAnts        ( 0 ),
-  m_deadAnts             ( 0 ),
+  m_stateCounters        (),
   m_evaporationRate      ( 0.0 ),
   m_pheromoneEnabled     ( true ),
   m_smartPheromoneEnabled( true ),
   m_maxNodesRemembered   ( 5 ),
+  m_seed                 ( static_cast< std::uint64_t >( time( 0 ) ) ),
+  m_antsRegistered       ( 0 ),
+  m_threadPool           ( static_cast< int >( std::thread::hardware_concurrency() ) ),
+  m_regionColumns        ( 1 ),
+  m_regionRows           ( 1 ),
+  m_regionsChanged       ( false ),
+  m_regions              (),
+  m_tileRegion           (),
   m_ants                 (),
+  m_antPool              (),
+  m_gatheringAnts        (),
   m_pheromones           (),
-  m_currentShortestPath  ()
-{
-  /* Seed rand for the duration of the sim's run. */
-  srand( time( 0 ) );
-}
+  m_pheromoneHooks       (),
+  m_pheromoneField       (),
+  m_worldTiles           (),
+  m_tileGrid             (),
+  m_neighbourTable       (),
+  m_gridOrigin           (),
+  m_currentShortestPath  (),
+  m_visibleAreaSet       ( false ),
+  m_fullPheromoneSnapshots( false ),
+  m_visibleTopLeft       (),
+  m_visibleBottomRight   () {}
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -94,26 +116,45 @@ void AntWorld::registerAnt( const AntPosition& position )
 {
   /* Since ants are constantly moving, we are not concerned with ants spawning in the
    * same position (unlike pheromones and tiles which stay put and shouldn't be duplicated). */
-  AntBot* ant = createAnt( position );
+  if( m_antPool.empty() )
+  {
+    m_ants.push_back( SharedAntPtr( createAnt( position ) ) );
+  }
+  else
+  {
+    m_ants.push_back( std::move( m_antPool.back() ) );
+    m_antPool.pop_back();
+    m_ants.back()->reset( position );
+  }
+
+  AntBot* ant = m_ants.back().get();
   ant->setMaxNodesRemembered( m_maxNodesRemembered );
-  m_ants.push_back( SharedAntPtr( ant ) );
+  ant->setRandomStream( m_seed, m_antsRegistered++ );
+  ant->setStateCounters( &m_stateCounters );
+  ant->flushGraphics();
+
+  if( !m_regions.empty() && !m_regionsChanged ) m_regions[ regionAt( position, 0 ) ].ants.push_back( ant );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntWorld::registerPheromone( const AntPosition& position, AntPheromone::PheromoneType type, SharedAntPtr& ant )
+void AntWorld::registerPheromone( const AntPosition& position, AntPheromone::PheromoneType type, const SharedAntPtr& ant )
 {
-  if( m_pheromoneEnabled ||
-      m_smartPheromoneEnabled )
+  /* Pheromones can only be dropped onto tiles (the field has a slot per tile). */
+  int index = tileIndex( position );
+
+  if( ( m_pheromoneEnabled ||
+        m_smartPheromoneEnabled ) &&
+      index != AntGrid::Empty )
   {
-    AntPheromone* pheromone = findPheromone( position );
+    bool dropped = m_pheromoneField.containsPheromone( index );
 
-    if( pheromone )
+    if( dropped )
     {
       /* Don't change the type if the pheromone is a hazard pheromone. */
-      if( pheromone->pheromoneType() != AntPheromone::Hazard )
+      if( m_pheromoneField.type( index ) != AntPheromone::Hazard )
       {
-        pheromone->setPheromoneType( type );
+        m_pheromoneField.setType( index, type );
       }
     }
     else
@@ -123,21 +164,17 @@ void AntWorld::registerPheromone( const AntPosition& position, AntPheromone::Phe
       if ( ( type == AntPheromone::Hazard && m_smartPheromoneEnabled ) ||
            ( type != AntPheromone::Hazard && m_pheromoneEnabled ) )
       {
-        pheromone = createPheromone( position, type );
-        pheromone->setEvaporationRate( m_evaporationRate );
-        m_pheromones.push_back( SharedPherPtr( pheromone ) );
+        m_pheromoneField.addPheromone( index, type, m_evaporationRate );
 
-        /* Register the pheromone with the tile it was dropped on. */
-        AntWorldTile* tile = findTile( position );
-        if( tile ) tile->registerPheromone( m_pheromones.back() );
+        AntPheromone* pheromone = createPheromone( position, type );
+        pheromone->attach( &m_pheromoneField, index );
+        m_pheromoneHooks[ index ] = static_cast< int >( m_pheromones.size() );
+        m_pheromones.push_back( SharedPherPtr( pheromone ) );
+        dropped = true;
       }
     }
 
-    if ( pheromone )
-    {
-      pheromone->registerAnt( ant );
-      ant->registerPheromonePosition( pheromone->position() );
-    }
+    if( dropped ) ant->registerPheromonePosition( m_worldTiles[ index ]->centre(), m_pheromoneField.serial( index ) );
   }
 }
 
@@ -145,7 +182,35 @@ void AntWorld::registerPheromone( const AntPosition& position, AntPheromone::Phe
 
 void AntWorld::registerWorldTile( const AntPosition& position, AntWorldTile::TileType type )
 {
-  if( !findTile( position ) ) m_worldTiles.push_back( createWorldTile( position, type ) );
+  /* The first tile registered anchors the grid at ( 0, 0 ). */
+  if( m_worldTiles.empty() ) m_gridOrigin = position;
+
+  int row( 0 );
+  int column( 0 );
+  gridCoordinates( position, row, column );
+
+  if( !tileAt( row, column ) )
+  {
+    m_worldTiles.push_back( createWorldTile( position, type ) );
+
+    int index = static_cast< int >( m_worldTiles.size() ) - 1;
+    m_tileGrid.insert( row, column, index );
+    linkNeighbours( row, column, index );
+
+    m_pheromoneField.addTile();
+    m_pheromoneHooks.push_back( -1 );
+    m_worldTiles.back()->setPheromoneField( &m_pheromoneField, index );
+
+    m_regionsChanged = true;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::setWorldTileType( const AntPosition& position, AntWorldTile::TileType type )
+{
+  AntWorldTile* tile = findTile( position );
+  if( tile ) tile->setTileType( type );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -153,10 +218,12 @@ void AntWorld::registerWorldTile( const AntPosition& position, AntWorldTile::Til
 void AntWorld::resetAntRegister()
 {
   m_ants.clear();
-  m_foragingAnts = 0;
-  m_gatheringAnts = 0;
-  m_deadAnts = 0;
+  m_antPool.clear();
+  m_stateCounters.reset();
+  m_antsRegistered = 0;
+  m_gatheringAnts.clear();
   m_currentShortestPath.clear();
+  m_regionsChanged = true;
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -164,6 +231,8 @@ void AntWorld::resetAntRegister()
 void AntWorld::resetPheromoneRegister()
 {
   m_pheromones.clear();
+  m_pheromoneHooks.assign( m_pheromoneHooks.size(), -1 );
+  m_pheromoneField.removePheromones();
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -172,106 +241,454 @@ void AntWorld::resetWorldTileRegister()
 {
   deletePointers( m_worldTiles );
   removeNullPointers( m_worldTiles );
+  m_tileGrid.clear();
+  m_neighbourTable.clear();
+
+  /* Pheromones can't outlive the tiles they were dropped on. */
+  m_pheromones.clear();
+  m_pheromoneHooks.clear();
+  m_pheromoneField.clear();
+  m_regionsChanged = true;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntWorld::tileIndex( const AntPosition& position ) const
+{
+  int row( 0 );
+  int column( 0 );
+  return gridCoordinates( position, row, column ) ? m_tileGrid.value( row, column ) : AntGrid::Empty;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntWorldTile* AntWorld::findTile( const AntPosition& position ) const
+{
+  int index = tileIndex( position );
+  return ( index != AntGrid::Empty ) ? m_worldTiles[ index ] : nullptr;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntWorldTile* AntWorld::tileAt( int row, int column ) const
+{
+  int index = m_tileGrid.value( row, column );
+  return ( index != AntGrid::Empty ) ? m_worldTiles[ index ] : nullptr;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntWorld::gridCoordinates( const AntPosition& position, int& row, int& column ) const
+{
+  if( m_worldTiles.empty() ) return false;
+
+  column = static_cast< int >( std::lround( ( position.x() - m_gridOrigin.x() ) / AntConfig::TileSize ) );
+  row = static_cast< int >( std::lround( ( position.y() - m_gridOrigin.y() ) / AntConfig::TileSize ) );
+  return true;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-AntPheromone* AntWorld::findPheromone( const AntPosition& position )
+void AntWorld::linkNeighbours( int row, int column, int index )
 {
-  auto pher = std::find_if( std::begin( m_pheromones ), std::end( m_pheromones ),
-                            [ &position ]( SharedPherPtr& p ){ return p && p->position() == position; } );
+  m_neighbourTable.resize( m_neighbourTable.size() + AntNeighbours::MaxNeighbours, AntGrid::Empty );
+
+  /* Since we're working in a 2D grid, the 4 neighbour tiles are simply those in the
+   * adjacent rows and columns. Each tile's valid entries are kept at the front of its
+   * slots (see AntNeighbours). */
+  const int adjacent[] = { m_tileGrid.value( row + 1, column ),
+                           m_tileGrid.value( row - 1, column ),
+                           m_tileGrid.value( row, column + 1 ),
+                           m_tileGrid.value( row, column - 1 ) };
 
-  return ( pher != std::end( m_pheromones ) ) ? ( *pher ).get() : nullptr;
+  for( auto neighbour : adjacent )
+  {
+    if( neighbour != AntGrid::Empty )
+    {
+      *std::find( m_neighbourTable.begin() + index * AntNeighbours::MaxNeighbours,
+                  m_neighbourTable.begin() + ( index + 1 ) * AntNeighbours::MaxNeighbours,
+                  AntGrid::Empty ) = neighbour;
+
+      *std::find( m_neighbourTable.begin() + neighbour * AntNeighbours::MaxNeighbours,
+                  m_neighbourTable.begin() + ( neighbour + 1 ) * AntNeighbours::MaxNeighbours,
+                  AntGrid::Empty ) = index;
+    }
+  }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-AntWorldTile* AntWorld::findTile( const AntPosition& position )
+AntNeighbours AntWorld::neighbours( const AntPosition& position ) const
 {
-  auto tile = std::find_if( std::begin( m_worldTiles ), std::end( m_worldTiles ),
-                            [ &position ]( AntWorldTile*& t ){ return t && t->centre() == position; } );
+  int row( 0 );
+  int column( 0 );
+
+  if( gridCoordinates( position, row, column ) )
+  {
+    int index = m_tileGrid.value( row, column );
+
+    if( index != AntGrid::Empty )
+    {
+      return AntNeighbours( &m_neighbourTable[ index * AntNeighbours::MaxNeighbours ], m_worldTiles.data() );
+    }
+  }
 
-  return ( tile != std::end( m_worldTiles ) ) ? *tile : nullptr;
+  return AntNeighbours();
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntWorld::updateAnts()
 {
-  m_foragingAnts = 0;
-  m_gatheringAnts = 0;
+  if( m_regionsChanged ) updateRegions();
 
-  for( auto& ant : m_ants )
+  /* Take the next step first (we know where we are, but don't know where we are going).
+   * Since ants only read the world while advancing (pheromones dropped during this phase
+   * are only registered below), they don't depend on one another and can advance in parallel,
+   * either in chunks or region by region. */
+  if( m_regions.empty() )
   {
-    /* Take the next step first (we know where we are, but don't know where we are going). */
-    ant->advance();
+    m_threadPool.run( static_cast< int >( m_ants.size() ), AntsPerTask,
+                      [ this ]( int begin, int end ){ for( int i = begin; i < end; ++i ) m_ants[ i ]->advance(); } );
+  }
+  else
+  {
+    m_threadPool.run( static_cast< int >( m_regions.size() ), 1,
+                      [ this ]( int begin, int end )
+                      {
+                        for( int i = begin; i < end; ++i ) for( auto ant : m_regions[ i ].ants ) ant->advance();
+                      } );
+  }
+
+  /* Then apply the ants' effects on the world in registration order (which keeps the
+   * results independent of the number of threads), noting down the gathering ants on the
+   * way so that the logic below and the deposits only visit those. */
+  m_gatheringAnts.clear();
+  bool antsDied = false;
+
+  for( std::vector< SharedAntPtr >::size_type i = 0; i < m_ants.size(); ++i )
+  {
+    const SharedAntPtr& ant = m_ants[ i ];
+
+    ant->flushGraphics();
 
     if( ant->droppedPheromone() ) registerPheromone( ant->position(), ant->droppedPheromoneType(), ant );
 
-    doGatheringAntLogic( ant );
-    doAntPheromoneDeregistration( ant );
+    if( ant->isDead() )
+    {
+      antsDied = true;
+    }
+    else if( ant->isGathering() )
+    {
+      m_gatheringAnts.push_back( static_cast< int >( i ) );
+    }
   }
 
-  doDeadAntLogic();
-  doForagingAntLogic();
+  if( !m_regions.empty() ) migrateAnts();
+
+  doDeadAntLogic( antsDied );
+  doGatheringAntLogic();
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntWorld::updatePheromones()
 {
-  m_pheromones.erase( std::remove_if( std::begin( m_pheromones ), std::end( m_pheromones ),
-                                      []( SharedPherPtr& p ){ return p->evaporated(); } ),
-                      std::end( m_pheromones ) );
+  /* Remove the pheromones that evaporated during the previous tick. */
+  if( m_pheromoneField.lazyEvaporation() )
+  {
+    for( int index : m_pheromoneField.expiredPheromones() ) removePheromone( index );
+  }
+  else
+  {
+    std::size_t kept = 0;
+
+    for( std::size_t i = 0; i < m_pheromones.size(); ++i )
+    {
+      int index = tileIndex( m_pheromones[ i ]->position() );
+
+      if( m_pheromones[ i ]->evaporated() )
+      {
+        m_pheromoneField.removePheromone( index );
+        m_pheromoneHooks[ index ] = -1;
+      }
+      else
+      {
+        if( kept != i ) m_pheromones[ kept ] = std::move( m_pheromones[ i ] );
+        m_pheromoneHooks[ index ] = static_cast< int >( kept++ );
+      }
+    }
+
+    m_pheromones.resize( kept );
+  }
+
+  depositPheromones();
+
+  if( m_pheromoneField.lazyEvaporation() )
+  {
+    /* Only advances the tick and collects the pheromones that expire. */
+    m_pheromoneField.evaporate();
+  }
+  else
+  {
+    m_threadPool.run( m_pheromoneField.size(), TilesPerTask,
+                      [ this ]( int begin, int end ){ m_pheromoneField.evaporate( begin, end ); } );
+
+    for( auto& pher : m_pheromones ) pher->update();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::removePheromone( int index )
+{
+  int hook = m_pheromoneHooks[ index ];
+
+  if( hook != -1 )
+  {
+    m_pheromoneField.removePheromone( index );
+    m_pheromoneHooks[ index ] = -1;
+
+    /* The order of the hooks doesn't matter, so fill the gap with the last one. */
+    if( hook != static_cast< int >( m_pheromones.size() ) - 1 )
+    {
+      m_pheromones[ hook ] = std::move( m_pheromones.back() );
+      m_pheromoneHooks[ tileIndex( m_pheromones[ hook ]->position() ) ] = hook;
+    }
 
-  for( auto& pher : m_pheromones ) pher->update();
+    m_pheromones.pop_back();
+  }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntWorld::doGatheringAntLogic( const SharedAntPtr& ant )
+void AntWorld::depositPheromones()
 {
-  if( ant->isGathering() )
+  /* Pheromones don't keep track of the ants contributing to them, instead each ant keeps
+   * the positions of the pheromones on its path and adds its strength to the field's
+   * accumulators here (the field then folds the accumulated deposits into the strengths
+   * as part of the evaporation pass).  References to pheromones that have been removed
+   * since no longer match the tile's serial number and are skipped. */
+  if( m_regions.empty() )
+  {
+    /* Only gathering ants (which includes those dropping pheromone) have anything to deposit. */
+    for( int ant : m_gatheringAnts )
+    {
+      double strength = m_ants[ ant ]->droppedPheromoneStrength();
+
+      for( auto& ref : m_ants[ ant ]->registeredPheromones() )
+      {
+        int index = tileIndex( ref.position );
+        if( index != AntGrid::Empty && m_pheromoneField.serial( index ) == ref.serial ) m_pheromoneField.deposit( index, strength );
+      }
+    }
+
+    return;
+  }
+
+  /* Each region only writes to its own tiles, deposits on tiles elsewhere (ants' paths
+   * can span many regions) are queued for the owning region... */
+  m_threadPool.run( static_cast< int >( m_regions.size() ), 1, [ this ]( int begin, int end )
   {
-    m_gatheringAnts++;
+    for( int i = begin; i < end; ++i )
+    {
+      Region& region = m_regions[ i ];
+
+      for( auto ant : region.ants )
+      {
+        double strength = ant->droppedPheromoneStrength();
+        if( strength == 0.0 ) continue;
+
+        for( auto& ref : ant->registeredPheromones() )
+        {
+          int index = tileIndex( ref.position );
+          if( index == AntGrid::Empty || m_pheromoneField.serial( index ) != ref.serial ) continue;
+
+          int owner = m_tileRegion[ index ];
+
+          if( owner == i )
+          {
+            m_pheromoneField.deposit( index, strength );
+          }
+          else
+          {
+            Deposit deposit = { index, strength };
+            region.deposits[ owner ].push_back( deposit );
+          }
+        }
+      }
+    }
+  } );
 
-    if( ant->shortestPath().size() < m_currentShortestPath.size() ||
-        m_currentShortestPath.empty() )
+  /* ...which picks them up afterwards (in region order, which keeps the sums reproducible). */
+  m_threadPool.run( static_cast< int >( m_regions.size() ), 1, [ this ]( int begin, int end )
+  {
+    for( int i = begin; i < end; ++i )
     {
-      m_currentShortestPath = ant->shortestPath();
+      for( auto& source : m_regions )
+      {
+        for( auto& deposit : source.deposits[ i ] ) m_pheromoneField.deposit( deposit.tile, deposit.strength );
+        source.deposits[ i ].clear();
+      }
     }
+  } );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::updateRegions()
+{
+  m_regionsChanged = false;
+  m_regions.clear();
+  m_tileRegion.clear();
+
+  if( m_regionColumns * m_regionRows <= 1 ||
+      m_worldTiles.empty() )
+  {
+    return;
+  }
+
+  /* Split the bounding box of the grid into equally sized rectangles. */
+  std::vector< int > rows( m_worldTiles.size() );
+  std::vector< int > columns( m_worldTiles.size() );
+
+  for( std::vector< AntWorldTile* >::size_type i = 0; i < m_worldTiles.size(); ++i )
+  {
+    gridCoordinates( m_worldTiles[ i ]->centre(), rows[ i ], columns[ i ] );
+  }
+
+  int firstRow = *std::min_element( std::begin( rows ), std::end( rows ) );
+  int firstColumn = *std::min_element( std::begin( columns ), std::end( columns ) );
+  int height = *std::max_element( std::begin( rows ), std::end( rows ) ) - firstRow + 1;
+  int width = *std::max_element( std::begin( columns ), std::end( columns ) ) - firstColumn + 1;
+
+  m_tileRegion.resize( m_worldTiles.size() );
+
+  for( std::vector< AntWorldTile* >::size_type i = 0; i < m_worldTiles.size(); ++i )
+  {
+    int regionRow = static_cast< int >( static_cast< long long >( rows[ i ] - firstRow ) * m_regionRows / height );
+    int regionColumn = static_cast< int >( static_cast< long long >( columns[ i ] - firstColumn ) * m_regionColumns / width );
+    m_tileRegion[ i ] = regionRow * m_regionColumns + regionColumn;
+  }
+
+  m_regions.resize( m_regionColumns * m_regionRows );
+
+  for( auto& region : m_regions )
+  {
+    region.migrants.resize( m_regions.size() );
+    region.deposits.resize( m_regions.size() );
   }
+
+  for( auto& ant : m_ants )
+  {
+    if( !ant->isDead() ) m_regions[ regionAt( ant->position(), 0 ) ].ants.push_back( ant.get() );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntWorld::regionAt( const AntPosition& position, int fallback ) const
+{
+  int index = tileIndex( position );
+  return ( index != AntGrid::Empty ) ? m_tileRegion[ index ] : fallback;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntWorld::doForagingAntLogic()
+void AntWorld::migrateAnts()
 {
-  m_foragingAnts = std::count_if( std::begin( m_ants ), std::end( m_ants ),
-                                  []( SharedAntPtr& a ){ return a->isForaging(); } );
+  /* Every region first sorts out the ants that have left it (or died)... */
+  m_threadPool.run( static_cast< int >( m_regions.size() ), 1, [ this ]( int begin, int end )
+  {
+    for( int i = begin; i < end; ++i )
+    {
+      Region& region = m_regions[ i ];
+      std::vector< AntBot* >::size_type staying = 0;
+
+      for( auto ant : region.ants )
+      {
+        if( ant->isDead() ) continue;
+
+        int destination = regionAt( ant->position(), i );
+
+        if( destination == i )
+        {
+          region.ants[ staying++ ] = ant;
+        }
+        else
+        {
+          region.migrants[ destination ].push_back( ant );
+        }
+      }
+
+      region.ants.resize( staying );
+    }
+  } );
+
+  /* ...and then collects the ants that have entered it from its neighbours. */
+  m_threadPool.run( static_cast< int >( m_regions.size() ), 1, [ this ]( int begin, int end )
+  {
+    for( int i = begin; i < end; ++i )
+    {
+      for( auto& source : m_regions )
+      {
+        std::vector< AntBot* >& arrivals = source.migrants[ i ];
+        m_regions[ i ].ants.insert( std::end( m_regions[ i ].ants ), std::begin( arrivals ), std::end( arrivals ) );
+        arrivals.clear();
+      }
+    }
+  } );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntWorld::doDeadAntLogic()
+void AntWorld::doGatheringAntLogic()
 {
-  m_deadAnts += std::count_if( std::begin( m_ants ), std::end( m_ants ),
-                               []( SharedAntPtr& a ){ return a->isDead(); } );
+  if( m_gatheringAnts.empty() ) return;
+
+  /* Find the (first) gathering ant with the shortest path and only then copy its path. */
+  const AntBot* shortest = m_ants[ m_gatheringAnts.front() ].get();
+
+  for( int ant : m_gatheringAnts )
+  {
+    if( m_ants[ ant ]->shortestPath().size() < shortest->shortestPath().size() ) shortest = m_ants[ ant ].get();
+  }
 
-  m_ants.erase( std::remove_if( std::begin( m_ants ), std::end( m_ants ),
-                                []( SharedAntPtr& a ){ return a->isDead(); } ),
-                std::end( m_ants ) );
+  if( shortest->shortestPath().size() < m_currentShortestPath.size() ||
+      m_currentShortestPath.empty() )
+  {
+    m_currentShortestPath = shortest->shortestPath();
+  }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntWorld::doAntPheromoneDeregistration( const SharedAntPtr& ant )
+void AntWorld::doDeadAntLogic( bool antsDied )
 {
-  for( auto& pos : ant->deRegisteredPheromonePositions() )
+  /* The dead are counted as they die (see AntStateCounters), all that's left is to remove them. */
+  if( !antsDied ) return;
+
+  /* Compact the registry in a single pass, renumbering the gathering ants as we go (ants
+   * don't die often enough for this to matter).  The dead are set aside for reuse by
+   * registerAnt rather than destroyed. */
+  std::vector< SharedAntPtr >::size_type live = 0;
+  m_gatheringAnts.clear();
+
+  for( std::vector< SharedAntPtr >::size_type i = 0; i < m_ants.size(); ++i )
   {
-    AntPheromone* pheromone = findPheromone( pos );
-    if( pheromone ) pheromone->deRegisterAnt( ant );
+    if( m_ants[ i ]->isDead() )
+    {
+      m_antPool.push_back( std::move( m_ants[ i ] ) );
+      continue;
+    }
+
+    if( live != i ) m_ants[ live ] = std::move( m_ants[ i ] );
+    if( m_ants[ live ]->isGathering() ) m_gatheringAnts.push_back( static_cast< int >( live ) );
+
+    ++live;
   }
+
+  m_ants.resize( live );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -279,7 +696,21 @@ void AntWorld::doAntPheromoneDeregistration( const SharedAntPtr& ant )
 void AntWorld::setEvaporationRate( double evaporationRate )
 {
   m_evaporationRate = evaporationRate;
-  for( auto& pher : m_pheromones ) pher->setEvaporationRate( m_evaporationRate );
+  m_pheromoneField.setEvaporationRate( m_evaporationRate );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::setLazyEvaporation( bool lazy )
+{
+  m_pheromoneField.setLazyEvaporation( lazy );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntWorld::lazyEvaporation() const
+{
+  return m_pheromoneField.lazyEvaporation();
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -293,21 +724,21 @@ int AntWorld::antCount() const
 
 int AntWorld::foragingAnts() const
 {
-  return m_foragingAnts;
+  return m_stateCounters.value( AntStateCounters::Foraging );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 int AntWorld::gatheringAnts() const
 {
-  return m_gatheringAnts;
+  return m_stateCounters.value( AntStateCounters::Gathering );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 int AntWorld::deadAnts() const
 {
-  return m_deadAnts;
+  return m_stateCounters.value( AntStateCounters::Dead );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -319,6 +750,103 @@ int AntWorld::shortestPathLength() const
 
 /*--------------------------------------------------------------------------------------*/
 
+void AntWorld::setThreadCount( int threadCount )
+{
+  m_threadPool.setThreadCount( threadCount );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntWorld::threadCount() const
+{
+  return m_threadPool.threadCount();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::setRegions( int columns, int rows )
+{
+  m_regionColumns = std::max( columns, 1 );
+  m_regionRows = std::max( rows, 1 );
+  m_regionsChanged = true;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntStats AntWorld::stats() const
+{
+  AntStats stats;
+  stats.ants = antCount();
+  stats.foraging = foragingAnts();
+  stats.gathering = gatheringAnts();
+  stats.dead = deadAnts();
+  stats.shortestPathLength = shortestPathLength();
+  return stats;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::snapshot( AntSnapshot& snapshot ) const
+{
+  snapshot.stats = stats();
+
+  snapshot.ants.clear();
+
+  for( const auto& ant : m_ants )
+  {
+    if( isVisible( ant->position() ) )
+    {
+      AntSnapshot::Ant shown = { ant->position(), ant->isReturning() };
+      snapshot.ants.push_back( shown );
+    }
+  }
+
+  snapshot.pheromones.clear();
+
+  for( const auto& pher : m_pheromones )
+  {
+    if( m_fullPheromoneSnapshots || isVisible( pher->position() ) )
+    {
+      AntSnapshot::Pheromone shown = { pher->position(), pher->pheromoneType(), pher->pheromoneStrength() };
+      snapshot.pheromones.push_back( shown );
+    }
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::setVisibleArea( const AntPosition& topLeft, const AntPosition& bottomRight )
+{
+  m_visibleAreaSet = true;
+  m_visibleTopLeft = topLeft;
+  m_visibleBottomRight = bottomRight;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::clearVisibleArea()
+{
+  m_visibleAreaSet = false;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntWorld::setFullPheromoneSnapshots( bool full )
+{
+  m_fullPheromoneSnapshots = full;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntWorld::isVisible( const AntPosition& position ) const
+{
+  return !m_visibleAreaSet ||
+         ( position.x() >= m_visibleTopLeft.x() && position.x() <= m_visibleBottomRight.x() &&
+           position.y() >= m_visibleTopLeft.y() && position.y() <= m_visibleBottomRight.y() );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
 void AntWorld::setPheromonesEnabled( bool enable )
 {
   m_pheromoneEnabled = enable;
@@ -340,3 +868,17 @@ void AntWorld::setMaxNodesRemembered( int maxNodesRemembered )
 }
 
 /*--------------------------------------------------------------------------------------*/
+
+void AntWorld::setSeed( std::uint64_t seed )
+{
+  m_seed = seed;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+std::uint64_t AntWorld::seed() const
+{
+  return m_seed;
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -31,7 +31,16 @@
 
 #include "antpheromone.h"
 #include "antworldtile.h"
+#include "antneighbours.h"
+#include "antpheromonefield.h"
+#include "antstats.h"
+#include "antsnapshot.h"
+#include "utils/antgrid.h"
+#include "utils/antpath.h"
+#include "utils/antthreadpool.h"
 #include <vector>
+#include <memory>
+#include <cstdint>
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -65,7 +74,10 @@ public:
 
   /*! Creates and registers an ant spawned at "position".  This function calls
    *  "createAnt" in order to populate the registry list and furthermore tells the
-   *  ant whether or not it must react to smart pheromones (default is "true").
+   *  ant whether or not it must react to smart pheromones (default is "true").  Ants that
+   *  have died are kept and reused here (see AntBot::reset), so "createAnt" is only called
+   *  when there are none left to reuse.  Reusing an ant doesn't allocate, i.e. once enough ants
+   *  have died, spawning and dying no longer touch the allocator.
    *
    *  \sa createAnt
    *  \sa setSmartPheromonesEnabled
@@ -79,6 +91,9 @@ public:
    */
   void registerWorldTile( const AntPosition& position, AntWorldTile::TileType type );
 
+  /*! Changes the type of the world tile at "position" (does nothing if there is none). */
+  void setWorldTileType( const AntPosition& position, AntWorldTile::TileType type );
+
   /*! Deletes all ants currently in the registry, sets all the ant counters (dead, foraging, gathering)
    *  back to zero and the shortest path to INT_MAX. */
   void resetAntRegister();
@@ -92,6 +107,22 @@ public:
   /*! Sets the desired pheromone evaporation rate. */
   void setEvaporationRate( double evaporationRate );
 
+  /*! Switches between evaporating every pheromone on each tick (default) and evaporating
+   *  lazily, in which case a pheromone's strength is only computed when it is read or
+   *  deposited on and evaporated pheromones are removed as their scheduled expiry comes up
+   *  (see AntPheromoneField::setLazyEvaporation).  The cost of a tick then scales with the
+   *  number of deposits rather than with the number of pheromones in the world, but the
+   *  pheromones' graphics are no longer updated as they fade.  Results differ slightly from
+   *  those of the default mode due to rounding.
+   *
+   *  \sa lazyEvaporation */
+  void setLazyEvaporation( bool lazy );
+
+  /*! Returns "true" if pheromones evaporate lazily.
+   *
+   *  \sa setLazyEvaporation */
+  bool lazyEvaporation() const;
+
   /*! Returns the number of ants currently in the registry.
    *  \sa foragingAnts
    *  \sa gatheringAnts
@@ -119,6 +150,38 @@ public:
   /*! Returns the current, known shortest path length (INT_MAX while no ant has found any target(s)). */
   int shortestPathLength() const;
 
+  /*! Returns a snapshot of all of the above.  The ant counters are maintained by the ants
+   *  themselves as they change state, so this function (like the individual getters) does
+   *  not visit any ants. */
+  AntStats stats() const;
+
+  /*! Copies the ants' and pheromones' positions and appearance, as well as the statistics,
+   *  into "snapshot" (the snapshot's tick is left to the caller).  The snapshot's vectors
+   *  are reused, so passing the same snapshot every time doesn't allocate.
+   *
+   *  \sa AntSimulation */
+  void snapshot( AntSnapshot& snapshot ) const;
+
+  /*! Restricts snapshots to the area from "topLeft" to "bottomRight" (e.g. the part of the
+   *  world shown in a view, the whole world is visible by default): snapshot leaves out the
+   *  ants and pheromones outside it (see setFullPheromoneSnapshots for the latter).  Neither
+   *  the simulation nor the ants' and pheromones' graphics hooks are affected.
+   *
+   *  \sa clearVisibleArea */
+  void setVisibleArea( const AntPosition& topLeft, const AntPosition& bottomRight );
+
+  /*! Makes the whole world visible again.
+   *
+   *  \sa setVisibleArea */
+  void clearVisibleArea();
+
+  /*! Sets whether snapshot includes all pheromones rather than only those in the visible
+   *  area (default "false"), e.g. for a heatmap of the whole world.  Ants are left out
+   *  regardless.
+   *
+   *  \sa setVisibleArea */
+  void setFullPheromoneSnapshots( bool full );
+
   /*! Enables pheromones (default) or disables pheromones (ants will not react
    *  to pheromone in their environment). */
   void setPheromonesEnabled( bool enable );
@@ -130,6 +193,53 @@ public:
   /*! Sets the maximum number of nodes that ants should "remember" at any given time. */
   void setMaxNodesRemembered( int maxNodesRemembered );
 
+  /*! Sets the seed from which the ants' random number streams are derived (the default
+   *  seed is based on the time at which the world was created).  Each ant gets its own
+   *  stream, numbered in the order in which the ants are registered, so that a given seed
+   *  always reproduces the same run.  The stream numbering restarts whenever the ant
+   *  register is reset, i.e. call this function before registering any ants.
+   *
+   *  \sa seed */
+  void setSeed( std::uint64_t seed );
+
+  /*! Returns the seed from which the ants' random number streams are derived.
+   *
+   *  \sa setSeed */
+  std::uint64_t seed() const;
+
+  /*! Sets the number of threads that ants are advanced on during each tick (the default is
+   *  the number of hardware threads).  Ants only see the pheromones as they were at the end
+   *  of the previous tick and everything they change in the world is applied afterwards in
+   *  registration order, so results do not depend on the number of threads.
+   *
+   *  \sa threadCount */
+  void setThreadCount( int threadCount );
+
+  /*! Returns the number of threads that ants are advanced on during each tick.
+   *
+   *  \sa setThreadCount */
+  int threadCount() const;
+
+  /*! Partitions the world grid into "columns" x "rows" equally sized rectangular regions
+   *  (default 1 x 1, i.e. no partitioning).  Each region keeps its own list of the ants on its
+   *  tiles and is processed by one thread at a time: its ants are advanced together, ants that
+   *  cross into another region are handed over through a queue per destination region and
+   *  pheromone deposits are only ever written by the region owning the tile (deposits on
+   *  other regions' tiles are queued in the same way).  This keeps threads working on
+   *  disjoint parts of the pheromone field in very large worlds.  Use roughly as many regions
+   *  as there are threads.  A given seed reproduces the same run for a given partitioning (the
+   *  order in which deposits are summed depends on it).
+   *
+   *  \sa setThreadCount */
+  void setRegions( int columns, int rows );
+
+  /*! Returns a view of all the world tiles immediately adjacent to that of the tile with
+   *  centre node position "position".  The neighbours are read from a table that is kept
+   *  up to date as tiles are registered, so this function neither searches nor allocates.
+   *
+   *  \sa AntNeighbours */
+  AntNeighbours neighbours( const AntPosition& position ) const;
+
 protected:
   /*! Constructor. */
   AntWorld();
@@ -156,26 +266,61 @@ private:
   /*! AntWorld is not assignable. */
   AntWorld& operator=( const AntWorld& ) = delete;
 
-  /*! Returns nullptr if no pheromone is found at "position". */
-  AntPheromone* findPheromone( const AntPosition& position );
+  /*! Returns true if "position" is in the visible area (see setVisibleArea). */
+  bool isVisible( const AntPosition& position ) const;
+
+  /*! Returns the registry index of the tile at "position" (which is also the tile's index
+   *  into the pheromone field) or AntGrid::Empty if there is none (constant time). */
+  int tileIndex( const AntPosition& position ) const;
 
   /*! Returns nullptr if no tile is found at "position". */
-  AntWorldTile* findTile( const AntPosition& position );
+  AntWorldTile* findTile( const AntPosition& position ) const;
 
-  /*! Called on each tick to update the ant registry. */
+  /*! Returns nullptr if no tile is registered at ( "row", "column" ). */
+  AntWorldTile* tileAt( int row, int column ) const;
+
+  /*! Adds the tile at ( "row", "column" ) with registry index "index" to the neighbour
+   *  table, linking it to (and from) whichever of its four neighbours already exist. */
+  void linkNeighbours( int row, int column, int index );
+
+  /*! Converts "position" to integer grid coordinates. Tiles are laid out on a regular
+   *  grid (AntConfig::TileSize apart) anchored at the centre of the first tile registered,
+   *  so rounding to the nearest grid line is immune to floating point drift in the
+   *  (possibly serialised) tile centres. Returns "false" while no tiles are registered. */
+  bool gridCoordinates( const AntPosition& position, int& row, int& column ) const;
+
+  /*! Called on each tick to update the ant registry.  The ants are advanced concurrently
+   *  (see setThreadCount) after which the pheromones they dropped, their graphics and the
+   *  ant counters are updated one ant at a time. */
   void updateAnts();
 
   /*! Called on each tick to update the pheromone registry. */
   void updatePheromones();
 
-  /*! Update details regarding gathering ants. */
-  void doGatheringAntLogic( const SharedAntPtr &ant );
+  /*! Removes the pheromone on the tile at "index" (along with its graphics hook). */
+  void removePheromone( int index );
+
+  /*! Has every ant that is dropping pheromone deposit its strength onto the pheromones on
+   *  its path (see AntPheromoneField::deposit). */
+  void depositPheromones();
 
-  /*! Update details regarding foraging ants. */
-  void doForagingAntLogic();
+  /*! Rebuilds the tile to region map and redistributes the ants over the regions
+   *  (see setRegions). */
+  void updateRegions();
 
-  /*! Update details regarding foraging ants. */
-  void doDeadAntLogic();
+  /*! Returns the region containing the tile at "position" ("fallback" if there is no such tile). */
+  int regionAt( const AntPosition& position, int fallback ) const;
+
+  /*! Removes dead ants from the regions and moves the ants that have left their region
+   *  to the region they are now in. */
+  void migrateAnts();
+
+  /*! Update details regarding gathering ants. */
+  void doGatheringAntLogic();
+
+  /*! Update details regarding dead ants (and remove them from the registry).  Does nothing
+   *  unless "antsDied" is "true". */
+  void doDeadAntLogic( bool antsDied );
 
   /*! Creates and registers a pheromone dropped at "position" by "ant". This function calls
    *  "createPheromone" in order to populate the registry list.
@@ -185,15 +330,31 @@ private:
    *  \sa createPheromone
    *  \sa setPheromonesEnabled
    */
-  void registerPheromone( const AntPosition& position, AntPheromone::PheromoneType type, SharedAntPtr& ant );
-
-  /*! Deregisters "ant" from all registered pheromones. */
-  void doAntPheromoneDeregistration( const SharedAntPtr &ant );
+  void registerPheromone( const AntPosition& position, AntPheromone::PheromoneType type, const SharedAntPtr& ant );
 
 private:
-  int m_foragingAnts;
-  int m_gatheringAnts;
-  int m_deadAnts;
+  /*! The number of ants advanced per task when spreading the ants over threads. */
+  static const int AntsPerTask = 64;
+
+  /*! The number of tiles evaporated per task when spreading the pheromone field over threads. */
+  static const int TilesPerTask = 8192;
+
+  /*! A pheromone deposit queued for the region owning "tile". */
+  struct Deposit
+  {
+    int tile;
+    double strength;
+  };
+
+  /*! A rectangular part of the world grid (see setRegions). */
+  struct Region
+  {
+    std::vector< AntBot* > ants;                        // ants currently on the region's tiles
+    std::vector< std::vector< AntBot* > > migrants;     // ants leaving, per destination region
+    std::vector< std::vector< Deposit > > deposits;     // deposits on other regions' tiles, per owner
+  };
+
+  AntStateCounters m_stateCounters;
 
   double m_evaporationRate;
 
@@ -202,10 +363,31 @@ private:
 
   unsigned int m_maxNodesRemembered;
 
+  std::uint64_t m_seed;
+  std::uint64_t m_antsRegistered;                       // next ant's random stream
+
+  AntThreadPool m_threadPool;
+  int m_regionColumns;
+  int m_regionRows;
+  bool m_regionsChanged;                                // m_regions needs rebuilding
+  std::vector< Region > m_regions;                      // empty unless the grid is partitioned
+  std::vector< int > m_tileRegion;                      // indexed like m_worldTiles
   std::vector< SharedAntPtr > m_ants;
-  std::vector< SharedPherPtr > m_pheromones;
+  std::vector< SharedAntPtr > m_antPool;                // dead ants, reused by registerAnt
+  std::vector< int > m_gatheringAnts;                   // indices into m_ants (in registration order)
+  std::vector< SharedPherPtr > m_pheromones;            // graphics hooks, the state lives in m_pheromoneField
+  std::vector< int > m_pheromoneHooks;                  // per tile, index into m_pheromones (or -1)
+  AntPheromoneField m_pheromoneField;                   // indexed like m_worldTiles
   std::vector< AntWorldTile* > m_worldTiles;
-  std::vector< AntPosition > m_currentShortestPath;
+  AntGrid m_tileGrid;                                   // ( row, column ) -> index into m_worldTiles
+  std::vector< int > m_neighbourTable;                  // AntNeighbours::MaxNeighbours indices per tile
+  AntPosition m_gridOrigin;
+  AntPath m_currentShortestPath;
+
+  bool m_visibleAreaSet;                                // false while the whole world is visible
+  bool m_fullPheromoneSnapshots;
+  AntPosition m_visibleTopLeft;
+  AntPosition m_visibleBottomRight;
 };
 
 #endif // ANTWORLD_H
\ No newline at end of file
@@ -27,15 +27,16 @@
  */
 
 #include "antworldtile.h"
+#include "antpheromonefield.h"
 #include "utils/antconfig.h"
-#include <algorithm>
 
 /*--------------------------------------------------------------------------------------*/
 
 AntWorldTile::AntWorldTile()
-: m_type  ( Wall ),
-  m_centre( 0.0, 0.0 ),
-  m_pheromone() {}
+: m_type          ( Wall ),
+  m_centre        ( 0.0, 0.0 ),
+  m_pheromoneField( nullptr ),
+  m_index         ( 0 ) {}
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -63,26 +64,26 @@ AntWorldTile::TileType AntWorldTile::tileType() const
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntWorldTile::registerPheromone( SharedPheromonePtr pher )
+void AntWorldTile::setPheromoneField( const AntPheromoneField* field, int index )
 {
-  m_pheromone = pher;
+  m_pheromoneField = field;
+  m_index = index;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 AntPheromone::PheromoneType AntWorldTile::tilePheromoneType() const
 {
-  SharedPheromonePtr pher = m_pheromone.lock();
-  return ( pher ) ? pher->pheromoneType() : AntPheromone::None;
+  return m_pheromoneField ? m_pheromoneField->type( m_index ) : AntPheromone::None;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 double AntWorldTile::tilePheromoneStrength() const
 {
-  /* Possible that the pheromone has evaporated, but hasn't been deleted yet. */
-  SharedPheromonePtr pher = m_pheromone.lock();
-  return ( pher && !pher->evaporated() ) ? pher->pheromoneStrength() : AntConfig::PheromoneMin;
+  /* Possible that the pheromone has evaporated, but hasn't been deleted yet (tiles without
+   * pheromone have strength 0.0, i.e. they count as evaporated as well). */
+  return ( m_pheromoneField && !m_pheromoneField->evaporated( m_index ) ) ? m_pheromoneField->strength( m_index ) : AntConfig::PheromoneMin;
 }
 
 /*--------------------------------------------------------------------------------------*/
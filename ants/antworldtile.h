@@ -32,7 +32,9 @@
 #include "utils/antposition.h"
 #include "ants/antpheromone.h"
 
-#include <memory>
+/*--------------------------------------------------------------------------------------*/
+
+class AntPheromoneField;
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -47,8 +49,6 @@
 class AntWorldTile
 {
 public:
-  using SharedPheromonePtr = std::shared_ptr< const AntPheromone >;
-
   enum TileType
   {
     Path,   /*!< The tile forms part of an allowed path. */
@@ -85,27 +85,25 @@ public:
    *  \sa setTileType */
   TileType tileType() const;
 
-  /*! Sets the pheromone associated with this tile (i.e. the pheromone that's been "dropped"
-   *  onto it).  Only one pheromone can be associated with each tile.
+  /*! Sets the pheromone field holding the state of the pheromone "dropped" onto this tile
+   *  and the tile's index into it (called by AntWorld when the tile is registered).  Only
+   *  one pheromone can be associated with each tile.
    *
-   *  \sa deRegisterPheromone
    *  \sa tilePheromoneType
    *  \sa tilePheromoneStrength
    */
-  void registerPheromone( SharedPheromonePtr pher );
+  void setPheromoneField( const AntPheromoneField* field, int index );
 
   /*! Returns the pheromone type if the tile has a pheromone on it, "AntPheromone::None" if not.
    *
-   *  \sa registerPheromone
-   *  \sa deRegisterPheromone
+   *  \sa setPheromoneField
    */
   AntPheromone::PheromoneType tilePheromoneType() const;
 
   /*! Returns the pheromone strength if the tile has a pheromone on it, "AntConfig::PheromoneMin" if not
    *  (the value returned will always be >= 0.0)
    *
-   *  \sa registerPheromone
-   *  \sa deRegisterPheromone
+   *  \sa setPheromoneField
    */
   double tilePheromoneStrength() const;
 
@@ -128,7 +126,8 @@ private:
 
   TileType m_type;
   AntPosition m_centre;
-  std::weak_ptr< const AntPheromone > m_pheromone;
+  const AntPheromoneField* m_pheromoneField;
+  int m_index;
 };
 
 #endif // ANTWORLDTILE_H
\ No newline at end of file
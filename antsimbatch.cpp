@@ -0,0 +1,386 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antsimbatch.h"
+#include "headless/headlessantworld.h"
+
+#include <QFile>
+#include <QDomDocument>
+#include <cstdio>
+#include <climits>
+
+/*--------------------------------------------------------------------------------------*/
+
+AntSimBatch::AntSimBatch()
+: m_world                 ( new HeadlessAntWorld ),
+  m_random                (),
+  m_out                   ( stdout ),
+  m_err                   ( stderr ),
+  m_fileName              ( "" ),
+  m_nrAnts                ( 50 ),
+  m_maxTicks              ( 10000 ),
+  m_interval              ( 0 ),
+  m_evaporationRate       ( 0.5 ),
+  m_maxNodesRemembered    ( 5 ),
+  m_threadCount           ( m_world->threadCount() ),
+  m_regionColumns         ( 1 ),
+  m_regionRows            ( 1 ),
+  m_lazyEvaporation       ( false ),
+  m_pheromonesEnabled     ( true ),
+  m_smartPheromonesEnabled( true ),
+  m_stopCondition         ( Never ),
+  m_seed                  ( m_world->seed() ) {}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntSimBatch::~AntSimBatch()
+{
+  delete m_world;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntSimBatch::isBatchRun( int argc, char* argv[] )
+{
+  for( int i = 1; i < argc; ++i )
+  {
+    QString argument( argv[ i ] );
+    if( argument == "--batch" || argument == "--help" ) return true;
+  }
+
+  return false;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntSimBatch::run( const QStringList& arguments )
+{
+  if( arguments.contains( "--help" ) )
+  {
+    printUsage( arguments.first() );
+    return 0;
+  }
+
+  if( !parseArguments( arguments ) ||
+      !loadWorld( m_fileName ) )
+  {
+    return 1;
+  }
+
+  if( m_world->spawnPoints().empty() )
+  {
+    m_err << "Error: " << m_fileName << " has no spawn points.\n";
+    return 1;
+  }
+
+  m_world->setEvaporationRate( m_evaporationRate );
+  m_world->setMaxNodesRemembered( m_maxNodesRemembered );
+  m_world->setPheromonesEnabled( m_pheromonesEnabled );
+  m_world->setSmartPheromonesEnabled( m_smartPheromonesEnabled );
+  m_world->setSeed( m_seed );
+  m_world->setThreadCount( m_threadCount );
+  m_world->setRegions( m_regionColumns, m_regionRows );
+  m_world->setLazyEvaporation( m_lazyEvaporation );
+
+  /* Spawn points are chosen from a stream of their own (the ants use streams 0, 1, 2...). */
+  m_random.seed( m_seed, UINT64_MAX );
+
+  printHeader();
+
+  int tick = 0;
+
+  while( tick < m_maxTicks && !stopConditionMet() )
+  {
+    spawn();
+    m_world->tick();
+    ++tick;
+
+    if( m_interval > 0 && tick % m_interval == 0 ) printStats( tick );
+  }
+
+  /* Always report the final state (unless it was the last interval line). */
+  if( m_interval <= 0 || tick % m_interval != 0 ) printStats( tick );
+
+  return 0;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntSimBatch::parseArguments( const QStringList& arguments )
+{
+  for( int i = 1; i < arguments.size(); ++i )
+  {
+    const QString& argument = arguments.at( i );
+
+    /* Options taking a value. */
+    if( argument == "--world" ||
+        argument == "--ants" ||
+        argument == "--ticks" ||
+        argument == "--interval" ||
+        argument == "--evaporation" ||
+        argument == "--max-nodes" ||
+        argument == "--until" ||
+        argument == "--seed" ||
+        argument == "--threads" ||
+        argument == "--regions" )
+    {
+      if( i + 1 >= arguments.size() )
+      {
+        m_err << "Error: " << argument << " requires a value.\n";
+        return false;
+      }
+
+      const QString& value = arguments.at( ++i );
+      bool ok = true;
+
+      if( argument == "--world" )
+      {
+        m_fileName = value;
+      }
+      else if( argument == "--ants" )
+      {
+        m_nrAnts = value.toInt( &ok );
+        ok = ok && m_nrAnts > 0;
+      }
+      else if( argument == "--ticks" )
+      {
+        m_maxTicks = value.toInt( &ok );
+        ok = ok && m_maxTicks >= 0;
+      }
+      else if( argument == "--interval" )
+      {
+        m_interval = value.toInt( &ok );
+        ok = ok && m_interval >= 0;
+      }
+      else if( argument == "--evaporation" )
+      {
+        m_evaporationRate = value.toDouble( &ok );
+        ok = ok && m_evaporationRate >= 0.0 && m_evaporationRate <= 1.0;
+      }
+      else if( argument == "--max-nodes" )
+      {
+        m_maxNodesRemembered = value.toInt( &ok );
+        ok = ok && m_maxNodesRemembered >= 0;
+      }
+      else if( argument == "--seed" )
+      {
+        m_seed = value.toULongLong( &ok );
+      }
+      else if( argument == "--threads" )
+      {
+        m_threadCount = value.toInt( &ok );
+        ok = ok && m_threadCount > 0;
+      }
+      else if( argument == "--regions" )
+      {
+        /* <columns>x<rows> */
+        QStringList dimensions = value.split( 'x' );
+        ok = dimensions.size() == 2;
+
+        if( ok )
+        {
+          bool columnsOk = false;
+          bool rowsOk = false;
+          m_regionColumns = dimensions.at( 0 ).toInt( &columnsOk );
+          m_regionRows = dimensions.at( 1 ).toInt( &rowsOk );
+          ok = columnsOk && rowsOk && m_regionColumns > 0 && m_regionRows > 0;
+        }
+      }
+      else if( argument == "--until" )
+      {
+        if( value == "found" )        m_stopCondition = Found;
+        else if( value == "extinct" ) m_stopCondition = Extinct;
+        else ok = false;
+      }
+
+      if( !ok )
+      {
+        m_err << "Error: invalid value \"" << value << "\" for " << argument << ".\n";
+        return false;
+      }
+    }
+    else if( argument == "--no-pheromones" )
+    {
+      m_pheromonesEnabled = false;
+    }
+    else if( argument == "--no-smart-pheromones" )
+    {
+      m_smartPheromonesEnabled = false;
+    }
+    else if( argument == "--lazy-evaporation" )
+    {
+      m_lazyEvaporation = true;
+    }
+    else if( argument != "--batch" )
+    {
+      m_err << "Error: unknown option \"" << argument << "\" (see --help).\n";
+      return false;
+    }
+  }
+
+  if( m_fileName.isEmpty() )
+  {
+    m_err << "Error: no world file specified (see --help).\n";
+    return false;
+  }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntSimBatch::loadWorld( const QString& fileName )
+{
+  QFile file( fileName );
+
+  if( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+  {
+    m_err << "Error: " << fileName << ": " << file.errorString() << "\n";
+    return false;
+  }
+
+  QTextStream inStream( &file );
+  QString errMsg;
+  int errLine;
+  int errCol;
+
+  QDomDocument doc;
+
+  if( !doc.setContent( inStream.readAll(), &errMsg, &errLine, &errCol ) )
+  {
+    m_err << QString( "Error: XML Broken: %1, line: %2, column: %3\n" ).arg( errMsg ).arg( errLine ).arg( errCol );
+    return false;
+  }
+
+  m_world->reset();
+
+  QDomNodeList elements = doc.elementsByTagName( "GraphicsWorldTile" );
+
+  for( int i = 0; i < elements.size(); ++i )
+  {
+    QDomElement element = elements.at( i ).toElement();
+
+    /* Tiles are serialised as rectangles (see GraphicsWorldTile::serialise) whereas
+     * the sim works with tile centres. */
+    AntPosition centre( element.attribute( "x" ).toDouble() + element.attribute( "width" ).toDouble() / 2,
+                        element.attribute( "y" ).toDouble() + element.attribute( "height" ).toDouble() / 2 );
+
+    m_world->registerWorldTile( centre, static_cast< AntWorldTile::TileType >( element.attribute( "type" ).toInt() ) );
+  }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimBatch::spawn()
+{
+  AntStats stats = m_world->stats();
+
+  if( ( stats.ants + stats.dead ) < m_nrAnts )
+  {
+    /* Choose a random spawn point if there are more than one. */
+    int point = m_random.bounded( static_cast< int >( m_world->spawnPoints().size() ) );
+    m_world->registerAnt( m_world->spawnPoints().at( point ) );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntSimBatch::stopConditionMet() const
+{
+  switch( m_stopCondition )
+  {
+    case Found:
+      return m_world->shortestPathLength() != INT_MAX;
+    case Extinct:
+      return m_world->deadAnts() >= m_nrAnts;
+    case Never:
+      break;
+  }
+
+  return false;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimBatch::printHeader()
+{
+  m_out << "tick,shortest,dead,gathering,foraging\n";
+  m_out.flush();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimBatch::printStats( int tick )
+{
+  /* The shortest path is reported as -1 while no ant has found the target. */
+  AntStats stats = m_world->stats();
+
+  m_out << tick << ","
+        << ( ( stats.shortestPathLength == INT_MAX ) ? -1 : stats.shortestPathLength ) << ","
+        << stats.dead << ","
+        << stats.gathering << ","
+        << stats.foraging << "\n";
+  m_out.flush();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimBatch::printUsage( const QString& program )
+{
+  m_out << "Usage: " << program << " --batch --world <file> [options]\n"
+        << "\n"
+        << "Runs the sim without a window and writes the colony statistics to stdout\n"
+        << "as comma-separated values (tick,shortest,dead,gathering,foraging), the\n"
+        << "shortest path is -1 while no ant has found the target.\n"
+        << "\n"
+        << "Options:\n"
+        << "  --world <file>          the .world file to load (required)\n"
+        << "  --ants <n>              number of ants to spawn (default 50)\n"
+        << "  --ticks <n>             maximum number of ticks to run (default 10000)\n"
+        << "  --until <found|extinct> stop early once a path is found or all ants are dead\n"
+        << "  --interval <n>          also report the statistics every <n> ticks\n"
+        << "  --evaporation <rate>    pheromone evaporation rate, 0.0 - 1.0 (default 0.5)\n"
+        << "  --max-nodes <n>         nodes remembered by each ant (default 5)\n"
+        << "  --seed <n>              random seed, a given seed always reproduces the same\n"
+        << "                          run (default based on the current time)\n"
+        << "  --threads <n>           threads to advance the ants on, does not affect the\n"
+        << "                          results (default: all hardware threads)\n"
+        << "  --regions <c>x<r>       partition the world into <c> x <r> regions, each updated\n"
+        << "                          by one thread at a time (default 1x1, for very large\n"
+        << "                          worlds use about as many regions as threads)\n"
+        << "  --no-pheromones         disable pheromones\n"
+        << "  --no-smart-pheromones   disable smart (hazard) pheromones\n"
+        << "  --lazy-evaporation      only update pheromones when they are deposited on, for\n"
+        << "                          worlds with many more pheromones than active trails\n"
+        << "  --help                  show this message\n";
+  m_out.flush();
+}
+
+/*--------------------------------------------------------------------------------------*/
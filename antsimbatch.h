@@ -0,0 +1,131 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTSIMBATCH_H
+#define ANTSIMBATCH_H
+
+#include "utils/antrandom.h"
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+/*--------------------------------------------------------------------------------------*/
+
+class HeadlessAntWorld;
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief Runs a sim from the command line without a window.
+ *
+ *  A .world file is loaded into a HeadlessAntWorld which is then ticked as fast as
+ *  possible (rather than at the GUI timer's rate).  The same statistics the main window
+ *  displays (shortest path, dead, gathering and foraging ants) are written to stdout
+ *  as comma-separated values so that the output can be consumed by other tools.
+ */
+
+class AntSimBatch
+{
+public:
+  /*! Constructor. */
+  AntSimBatch();
+
+  /*! Destructor. */
+  ~AntSimBatch();
+
+  /*! Returns "true" if "arguments" (as passed to main) request a batch run. */
+  static bool isBatchRun( int argc, char* argv[] );
+
+  /*! Parses "arguments" (including the program name), runs the sim accordingly
+   *  and returns the process exit code. */
+  int run( const QStringList& arguments );
+
+private:
+  /*! Conditions (other than the maximum number of ticks) that end a run. */
+  enum StopCondition
+  {
+    Never,      /*!< Run for the full number of ticks. */
+    Found,      /*!< Stop as soon as any ant has found a path to the target. */
+    Extinct     /*!< Stop once all the ants have died. */
+  };
+
+  /*! AntSimBatch is not copyable. */
+  AntSimBatch( const AntSimBatch& ) = delete;
+
+  /*! AntSimBatch is not assignable. */
+  AntSimBatch& operator=( const AntSimBatch& ) = delete;
+
+  /*! Parses the command line "arguments", returns "false" (after reporting the
+   *  problem) if they are not valid. */
+  bool parseArguments( const QStringList& arguments );
+
+  /*! Loads the world from "fileName", returns "false" (after reporting the problem) if
+   *  the file could not be read. */
+  bool loadWorld( const QString& fileName );
+
+  /*! Spawns a new ant at a random spawn point for as long as the colony is smaller
+   *  than the requested number of ants (mirrors AntSimMainWindow::spawn). */
+  void spawn();
+
+  /*! Returns "true" once the requested stop condition has been met. */
+  bool stopConditionMet() const;
+
+  /*! Writes the statistics for "tick" as a comma-separated line.
+   *  \sa printHeader */
+  void printStats( int tick );
+
+  /*! Writes the comma-separated column names.
+   *  \sa printStats */
+  void printHeader();
+
+  /*! Writes the command line usage to stdout. */
+  void printUsage( const QString& program );
+
+private:
+  HeadlessAntWorld* m_world;
+  AntRandom m_random;
+  QTextStream m_out;
+  QTextStream m_err;
+
+  QString m_fileName;
+  int m_nrAnts;
+  int m_maxTicks;
+  int m_interval;
+  double m_evaporationRate;
+  int m_maxNodesRemembered;
+  int m_threadCount;
+  int m_regionColumns;
+  int m_regionRows;
+  bool m_lazyEvaporation;
+  bool m_pheromonesEnabled;
+  bool m_smartPheromonesEnabled;
+  StopCondition m_stopCondition;
+  std::uint64_t m_seed;
+};
+
+#endif // ANTSIMBATCH_H
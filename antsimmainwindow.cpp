@@ -29,8 +29,9 @@
 #include "antsimmainwindow.h"
 #include "ui_antsimmainwindow.h"
 #include "world/antworldscene.h"
-#include "world/graphicsantitem.h"
 #include "ants/antworld.h"
+#include "ants/antsimulation.h"
+#include "headless/headlessantworld.h"
 #include "utils/antconfig.h"
 
 #include <QTimer>
@@ -42,15 +43,23 @@
 
 /*--------------------------------------------------------------------------------------*/
 
+const int displayInterval = 16;   // milliseconds between checks for a new snapshot (about 60 frames per second)
+
+/*--------------------------------------------------------------------------------------*/
+
 AntSimMainWindow::AntSimMainWindow( QWidget* parent )
 : QMainWindow     ( parent ),
   ui              ( new Ui::AntSimMainWindow ),
   m_scene         ( new GraphicsAntWorldScene( this ) ),
+  m_world         ( new HeadlessAntWorld ),
+  m_simulation    ( new AntSimulation( m_world ) ),
   m_synchTimer    ( new QTimer( this ) ),
   m_totalTimer    (),
   m_elapsedTime   ( 0, 0, 0, 0 ),
   m_fileName      ( "" ),
-  m_stopped       ( true )
+  m_stopped       ( true ),
+  m_newRun        ( true ),
+  m_visibleArea   ()
 {
   ui->setupUi( this );
   showMaximized();
@@ -64,6 +73,7 @@ AntSimMainWindow::AntSimMainWindow( QWidget* parent )
   connect( ui->resetPushButton, SIGNAL( clicked() ), this, SLOT( reset() ) );
   connect( ui->pheromoneCheckBox, SIGNAL( toggled( bool ) ), this, SLOT( togglePheromones( bool ) ) );
   connect( ui->smartPheromoneCheckBox, SIGNAL( toggled( bool ) ), this, SLOT( toggleSmartPheromones( bool ) ) );
+  connect( ui->heatmapCheckBox, SIGNAL( toggled( bool ) ), this, SLOT( toggleHeatmap( bool ) ) );
 
   QButtonGroup* buttonGroup = new QButtonGroup( this );
   buttonGroup->addButton( ui->pathPushButton, 0 );
@@ -74,9 +84,13 @@ AntSimMainWindow::AntSimMainWindow( QWidget* parent )
   buttonGroup->addButton( ui->cursorPushButton, 5 );
   connect( buttonGroup, SIGNAL( buttonClicked( int ) ), this, SLOT( buttonClicked( int ) ) );
 
-  connect( ui->advanceRateSpinBox, SIGNAL( valueChanged( int ) ), m_synchTimer, SLOT( start( int ) ) );
-  connect( m_synchTimer, SIGNAL( timeout() ), this, SLOT( advance() ) );
-  m_synchTimer->setInterval( ui->advanceRateSpinBox->value() );
+  /* The sim runs on a thread of its own (at the advance rate), the window merely shows
+   * the latest snapshot it published every time the synch timer fires. */
+  connect( ui->advanceRateSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( setAdvanceRate( int ) ) );
+  connect( m_synchTimer, SIGNAL( timeout() ), this, SLOT( showSnapshot() ) );
+  connect( m_scene, SIGNAL( worldTileChanged( GraphicsWorldTile* ) ), this, SLOT( worldTileChanged( GraphicsWorldTile* ) ) );
+  m_simulation->setInterval( ui->advanceRateSpinBox->value() );
+  m_synchTimer->start( displayInterval );
 
   connect( ui->evaporationSpinBox, SIGNAL( valueChanged( double ) ), this, SLOT( setEvaporationRate( double ) ) );
   connect( ui->maxNodesSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( setMaxNodesRemembered( int ) ) );
@@ -88,6 +102,8 @@ AntSimMainWindow::AntSimMainWindow( QWidget* parent )
 
 AntSimMainWindow::~AntSimMainWindow()
 {
+  delete m_simulation;    // stops the sim before its world goes
+  delete m_world;
   delete ui;
 }
 
@@ -98,10 +114,9 @@ void AntSimMainWindow::initialise()
   ui->graphicsView->setScene( m_scene );
   m_scene->setSceneRect( ui->graphicsView->rect() );
 
+  reset();
   m_scene->constructWorldGrid();
   ui->graphicsView->fitInView( m_scene->sceneRect(), Qt::KeepAspectRatio );
-
-  m_scene->setEvaporationRate( ui->evaporationSpinBox->value() );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -133,16 +148,9 @@ void AntSimMainWindow::save()
       QDomElement root = doc.createElement( "AntSimWorld" );
       doc.appendChild( root );
 
-      QList< QGraphicsItem* > itemList = m_scene->items();
-
-      for( int i = 0; i < itemList.size(); ++i )
+      for( GraphicsWorldTile* tile : m_scene->worldTiles() )
       {
-        GraphicsWorldTile* tile = dynamic_cast< GraphicsWorldTile* >( itemList.at( i ) );
-
-        if( tile )
-        {
-          root.appendChild( tile->serialise() );
-        }
+        root.appendChild( tile->serialise() );
       }
 
       QTextStream outStream( &file );
@@ -205,19 +213,24 @@ void AntSimMainWindow::buttonClicked( int button )
 
 void AntSimMainWindow::reset()
 {
-  setAntStats();
-
-  m_scene->resetAntRegister();
-  m_scene->resetPheromoneRegister();
-
-  m_elapsedTime = QTime( 0, 0, 0, 0 );
-  ui->elapsedTimeEdit->setText( "00:00:00" );
-
   // Set the flag to "false" to force "stopped" functionality.
   // This is counter-intuitive, see startStopSim.
   m_stopped = false;
   startStopSim();
   ui->startPushButton->setText( "Start" );
+
+  m_simulation->post( []( AntWorld& world )
+                      {
+                        world.resetAntRegister();
+                        world.resetPheromoneRegister();
+                      } );
+
+  /* The world is rebuilt from the scene when the sim is started again, so that it
+   * includes any changes made to the tiles in the meantime. */
+  m_newRun = true;
+
+  m_elapsedTime = QTime( 0, 0, 0, 0 );
+  ui->elapsedTimeEdit->setText( "00:00:00" );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -236,9 +249,11 @@ void AntSimMainWindow::startStopSim()
 
     m_stopped = false;
 
-    // Connect this slot in case the nr of ants has changed.
-    connect( m_synchTimer, SIGNAL( timeout() ), this, SLOT( spawn() ) );
-    m_synchTimer->start();
+    if( m_newRun ) startNewRun();
+
+    // Set this in case the nr of ants has changed.
+    m_simulation->setAntCount( ui->nrAntsSpinBox->value() );
+    m_simulation->start();
 
     m_totalTimer.start();
   }
@@ -254,82 +269,94 @@ void AntSimMainWindow::startStopSim()
 
     m_stopped = true;
 
-    m_synchTimer->stop();
+    m_simulation->stop();
   }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntSimMainWindow::spawn()
+void AntSimMainWindow::showSnapshot()
 {
-  if( ( m_scene->antCount() + ui->deadLineEdit->text().toInt() ) < ui->nrAntsSpinBox->value() )
-  {
-    if( m_scene->spawnPoints().size() > 0 )
-    {
-      /* Choose a random spawn point if there are more than one. */
-      int point = qrand() % m_scene->spawnPoints().size();
-      m_scene->registerAnt( m_scene->spawnPoints().at( point )->centre() );
-    }
-  }
-  else
+  updateVisibleArea();
+
+  if( m_scene->takeSnapshot( *m_simulation ) )
   {
-    /* Once the desired nr of ants have been created, disconnect the timer from this slot. */
-    disconnect( m_synchTimer, SIGNAL( timeout() ), this, SLOT( spawn() ) );
+    setAntStats();
   }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntSimMainWindow::advance()
+void AntSimMainWindow::setAdvanceRate( int milliseconds )
 {
-  if( !m_stopped )
-  {
-    m_scene->tick();
-    setAntStats();
-  }
+  m_simulation->setInterval( milliseconds );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimMainWindow::worldTileChanged( GraphicsWorldTile* tile )
+{
+  AntPosition centre = tile->centre();
+  AntWorldTile::TileType type = tile->tileType();
+  m_simulation->post( [ centre, type ]( AntWorld& world ){ world.setWorldTileType( centre, type ); } );
+
+  updateSpawnPoints();
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntSimMainWindow::setEvaporationRate( double evaporationRate )
 {
-  m_scene->setEvaporationRate( evaporationRate );
+  m_simulation->post( [ evaporationRate ]( AntWorld& world ){ world.setEvaporationRate( evaporationRate ); } );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntSimMainWindow::togglePheromones( bool enable )
 {
-  m_scene->setPheromonesEnabled( enable );
+  m_simulation->post( [ enable ]( AntWorld& world ){ world.setPheromonesEnabled( enable ); } );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntSimMainWindow::toggleSmartPheromones( bool enable )
 {
-  m_scene->setSmartPheromonesEnabled( enable );
+  m_simulation->post( [ enable ]( AntWorld& world ){ world.setSmartPheromonesEnabled( enable ); } );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimMainWindow::toggleHeatmap( bool enable )
+{
+  /* The heatmap covers the whole world, so it needs the pheromones outside the view as well. */
+  m_scene->setHeatmapEnabled( enable );
+  m_simulation->post( [ enable ]( AntWorld& world ){ world.setFullPheromoneSnapshots( enable ); } );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntSimMainWindow::setMaxNodesRemembered( int maxNodesRemembered )
 {
-  m_scene->setMaxNodesRemembered( maxNodesRemembered );
+  m_simulation->post( [ maxNodesRemembered ]( AntWorld& world ){ world.setMaxNodesRemembered( maxNodesRemembered ); } );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntSimMainWindow::setAntStats()
 {
-  ui->gatheringLineEdit->setText( QString( "%1" ).arg( m_scene->gatheringAnts() ) );
-  ui->foragingLineEdit->setText( QString( "%1" ).arg( m_scene->foragingAnts() ) );
-  ui->deadLineEdit->setText( QString( "%1" ).arg( m_scene->deadAnts() ) );
-  ui->shortestLineEdit->setText( QString( "%1" ).arg( m_scene->shortestPathLength() ) );
-
-  /* Sets the elapsed time. */
-  m_elapsedTime = m_elapsedTime.addMSecs( m_totalTimer.elapsed() );
-  ui->elapsedTimeEdit->setText( m_elapsedTime.toString( "HH:mm:ss" ) );
-  m_totalTimer.restart();
+  const AntStats& stats = m_scene->snapshot().stats;
+  ui->gatheringLineEdit->setText( QString( "%1" ).arg( stats.gathering ) );
+  ui->foragingLineEdit->setText( QString( "%1" ).arg( stats.foraging ) );
+  ui->deadLineEdit->setText( QString( "%1" ).arg( stats.dead ) );
+  ui->shortestLineEdit->setText( QString( "%1" ).arg( stats.shortestPathLength ) );
+
+  /* Sets the elapsed time (the clock only runs while the sim does). */
+  if( !m_stopped )
+  {
+    m_elapsedTime = m_elapsedTime.addMSecs( m_totalTimer.elapsed() );
+    ui->elapsedTimeEdit->setText( m_elapsedTime.toString( "HH:mm:ss" ) );
+    m_totalTimer.restart();
+  }
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -349,6 +376,7 @@ void AntSimMainWindow::loadWorld( QString fileName )
 
     if( doc.setContent( inStream.readAll(), &errMsg, &errLine, &errCol ) )
     {
+      reset();
       m_scene->reset();
       m_scene->setSceneRect( QRectF() );
 
@@ -379,3 +407,52 @@ void AntSimMainWindow::loadWorld( QString fileName )
 }
 
 /*--------------------------------------------------------------------------------------*/
+
+void AntSimMainWindow::startNewRun()
+{
+  /* The sim isn't running, so its world can be accessed directly. */
+  m_world->reset();
+  m_scene->copyWorldTiles( *m_world );
+  m_world->setEvaporationRate( ui->evaporationSpinBox->value() );
+  m_world->setPheromonesEnabled( ui->pheromoneCheckBox->isChecked() );
+  m_world->setSmartPheromonesEnabled( ui->smartPheromoneCheckBox->isChecked() );
+  m_world->setMaxNodesRemembered( ui->maxNodesSpinBox->value() );
+  updateSpawnPoints();
+
+  m_newRun = false;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimMainWindow::updateSpawnPoints()
+{
+  std::vector< AntPosition > spawnPoints;
+
+  for( const GraphicsWorldTile* tile : m_scene->spawnPoints() )
+  {
+    spawnPoints.push_back( tile->centre() );
+  }
+
+  m_simulation->setSpawnPoints( spawnPoints );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntSimMainWindow::updateVisibleArea()
+{
+  /* Checked on every frame rather than tracking scrolling, zooming and resizing separately.
+   * The margin keeps ants and pheromones straddling the view's edges in view. */
+  QRectF visibleArea = ui->graphicsView->mapToScene( ui->graphicsView->viewport()->rect() ).boundingRect()
+                         .adjusted( -AntConfig::TileSize, -AntConfig::TileSize, AntConfig::TileSize, AntConfig::TileSize );
+
+  if( visibleArea != m_visibleArea )
+  {
+    m_visibleArea = visibleArea;
+
+    AntPosition topLeft( visibleArea.left(), visibleArea.top() );
+    AntPosition bottomRight( visibleArea.right(), visibleArea.bottom() );
+    m_simulation->post( [ topLeft, bottomRight ]( AntWorld& world ){ world.setVisibleArea( topLeft, bottomRight ); } );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -31,10 +31,14 @@
 
 #include <QDateTime>
 #include <QMainWindow>
+#include <QRectF>
 
 /*--------------------------------------------------------------------------------------*/
 
 class GraphicsAntWorldScene;
+class GraphicsWorldTile;
+class HeadlessAntWorld;
+class AntSimulation;
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -79,18 +83,20 @@ private slots:
   void buttonClicked( int button );
 
   /*! Starts the sim with the number of ants specified in the
-   *  relevant spin box.
-   *  \sa spawn */
+   *  relevant spin box (one ant is spawned per tick, which is purely
+   *  cosmetic in that it prevents new ants spawning on top of each
+   *  other). */
   void startStopSim();
 
-  /*! Spawns ants at the same rate as they advance, this is purely
-   *  cosmetic in that it prevents new ants spawning on top of each
-   *  other.
-   *  \sa startStopSim */
-  void spawn();
+  /*! Shows the latest snapshot of the sim (if there is a new one), called at display
+   *  rate regardless of how fast the sim is running. */
+  void showSnapshot();
 
-  /*! Advances all the ants to their next position. */
-  void advance();
+  /*! Sets the time between ticks of the sim. */
+  void setAdvanceRate( int milliseconds );
+
+  /*! Forwards a change made to "tile" in the editor to the sim. */
+  void worldTileChanged( GraphicsWorldTile* tile );
 
   /*! Resets the sim. */
   void reset();
@@ -106,6 +112,9 @@ private slots:
    *  smart pheromones will be disabled). */
   void toggleSmartPheromones( bool enable );
 
+  /*! Shows the pheromones as a heatmap over the world or (default) as individual pheromones. */
+  void toggleHeatmap( bool enable );
+
   /*! Sets the maximum number of nodes that ants should "remember" at any given time. */
   void setMaxNodesRemembered( int maxNodesRemembered );
 
@@ -116,14 +125,28 @@ private:
   /*! Loads the user selected world. */
   void loadWorld( QString fileName );
 
+  /*! Rebuilds the sim's world from the tiles in the scene and applies the current settings. */
+  void startNewRun();
+
+  /*! Passes the positions of the scene's spawn points to the sim. */
+  void updateSpawnPoints();
+
+  /*! Passes the part of the scene shown in the view to the sim if it changed (so that the sim
+   *  skips graphics work for everything else). */
+  void updateVisibleArea();
+
   Ui::AntSimMainWindow* ui;
-  GraphicsAntWorldScene* m_scene;
+  GraphicsAntWorldScene* m_scene;               // the editor, also shows the sim's snapshots
+  HeadlessAntWorld* m_world;                    // the world the sim runs on
+  AntSimulation* m_simulation;
 
   QTimer* m_synchTimer;
   QTime m_totalTimer;
   QTime m_elapsedTime;
   QString m_fileName;
   bool m_stopped;
+  bool m_newRun;                                // m_world must be rebuilt before the sim is started
+  QRectF m_visibleArea;                         // as last passed to the sim
 };
 
 #endif // ANTSIMMAINWINDOW_H
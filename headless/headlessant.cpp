@@ -26,64 +26,39 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#include "graphicsantitem.h"
-#include "graphicsworldtile.h"
-#include "antworldscene.h"
-#include "utils/antconfig.h"
+#include "headlessant.h"
+#include "ants/antworld.h"
 
 /*--------------------------------------------------------------------------------------*/
 
-GraphicsAntItem::GraphicsAntItem( const GraphicsAntWorldScene* scene, const AntPosition& position, const QPixmap& pixmap )
-: AntBot             ( position ),
-  QGraphicsPixmapItem( pixmap ),
-  m_scene            ( scene )
+HeadlessAnt::HeadlessAnt( const AntWorld* world, const AntPosition& position )
+: AntBot ( position ),
+  m_world( world )
 {
-  setZValue( 1.0 );           // always draw on top
   AntBot::updatePosition( position );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-std::vector< const AntWorldTile* > GraphicsAntItem::queryTerrain( const AntPosition& position )
+AntNeighbours HeadlessAnt::queryTerrain( const AntPosition& position )
 {
-  std::vector< const AntWorldTile* > tiles;
+  return m_world ? m_world->neighbours( position ) : AntNeighbours();
+}
 
-  if( m_scene )
-  {
-    tiles = m_scene->neighbours( position );
-  }
+/*--------------------------------------------------------------------------------------*/
 
-  return tiles;
-}
+void HeadlessAnt::updateGraphics( const AntPosition& /*position*/ ) {}
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsAntItem::updateGraphics( const AntPosition& position )
-{
-  if( m_scene )
-  {
-    /* The position passed in is the centre of the item so we need to cater for the
-     * offset to the item's top left corner. */
-    QPointF pointF( qreal( position.x() - boundingRect().width() / 2 ),
-                    qreal( position.y() - boundingRect().height() / 2 ) );
-    setPos( pointF );
-  }
-}
+void HeadlessAnt::showFoundGraphics() {}
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsAntItem::showFoundGraphics()
-{
-  QPixmap pixMap( ":/resources/foundant.png" );
-  setPixmap( pixMap.scaled( AntConfig::AntSize, AntConfig::AntSize, Qt::KeepAspectRatio ) );
-}
+void HeadlessAnt::showForageGraphics() {}
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsAntItem::showForageGraphics()
-{
-  QPixmap pixMap( ":/resources/ant.png" );
-  setPixmap( pixMap.scaled( AntConfig::AntSize, AntConfig::AntSize, Qt::KeepAspectRatio ) );
-}
+void HeadlessAnt::showDeadGraphics() {}
 
 /*--------------------------------------------------------------------------------------*/
@@ -26,42 +26,44 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#ifndef GRAPHICSANTITEM_H
-#define GRAPHICSANTITEM_H
+#ifndef HEADLESSANT_H
+#define HEADLESSANT_H
 
 #include "ants/antbot.h"
-#include <QGraphicsPixmapItem>
 
 /*--------------------------------------------------------------------------------------*/
 
-class GraphicsAntWorldScene;
+class AntWorld;
 
 /*--------------------------------------------------------------------------------------*/
 
-/*! \brief This class inherits from AntBot and is responsible for the graphical aspects of the ants. */
+/*! \brief This class inherits from AntBot and provides an ant without any graphical
+ *  representation (for use in batch runs where no QApplication is available). */
 
-class GraphicsAntItem : public AntBot,
-                        public QGraphicsPixmapItem
+class HeadlessAnt : public AntBot
 {
 public:
-  /*! Constructor. */
-  explicit GraphicsAntItem( const GraphicsAntWorldScene* scene, const AntPosition& position, const QPixmap& pixmap );
+  /*! Constructor ("world" is the world whose terrain the ant queries). */
+  explicit HeadlessAnt( const AntWorld* world, const AntPosition& position );
 
 protected:
   /*! Re-implemented from AntBot. */
-  std::vector< const AntWorldTile* > queryTerrain( const AntPosition& position );
+  AntNeighbours queryTerrain( const AntPosition& position );
 
-  /*! Re-implemented from AntBot. */
+  /*! Re-implemented from AntBot (does nothing). */
   void updateGraphics( const AntPosition& position );
 
-  /*! Re-implemented from AntBot. */
+  /*! Re-implemented from AntBot (does nothing). */
   void showFoundGraphics();
 
-  /*! Re-implemented from AntBot. */
+  /*! Re-implemented from AntBot (does nothing). */
   void showForageGraphics();
 
+  /*! Re-implemented from AntBot (does nothing). */
+  void showDeadGraphics();
+
 private:
-  const GraphicsAntWorldScene* m_scene;
+  const AntWorld* m_world;
 };
 
-#endif // GRAPHICSANTITEM_H
+#endif // HEADLESSANT_H
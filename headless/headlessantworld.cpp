@@ -17,7 +17,7 @@
  * version.
  *
  * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warrorganismy of MERCHANTABILITY or FITNESS
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
  * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
  *
  * You should have received a copy of the GNU General Public License along with
@@ -26,64 +26,60 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#include "graphicsorganismitem.h"
-#include "graphicsworldtile.h"
-#include "organismworldscene.h"
-#include "utils/organismconfig.h"
+#include "headlessantworld.h"
+#include "headlessant.h"
+#include "headlesspheromone.h"
+#include "headlessworldtile.h"
 
 /*--------------------------------------------------------------------------------------*/
 
-GraphicsAntItem::GraphicsAntItem( const GraphicsAntWorldScene* scene, const AntPosition& position, const QPixmap& pixmap )
-: AntBot             ( position ),
-  QGraphicsPixmapItem( pixmap ),
-  m_scene            ( scene )
-{
-  setZValue( 1.0 );           // always draw on top
-  AntBot::updatePosition( position );
-}
+HeadlessAntWorld::HeadlessAntWorld()
+: AntWorld     (),
+  m_spawnPoints() {}
 
 /*--------------------------------------------------------------------------------------*/
 
-std::vector< const AntWorldTile* > GraphicsAntItem::queryTerrain( const AntPosition& position )
+void HeadlessAntWorld::reset()
 {
-  std::vector< const AntWorldTile* > tiles;
+  resetAntRegister();
+  resetPheromoneRegister();
+  resetWorldTileRegister();
+  m_spawnPoints.clear();
+}
 
-  if( m_scene )
-  {
-    tiles = m_scene->neighbours( position );
-  }
+/*--------------------------------------------------------------------------------------*/
 
-  return tiles;
+const std::vector< AntPosition >& HeadlessAntWorld::spawnPoints() const
+{
+  return m_spawnPoints;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsAntItem::updateGraphics( const AntPosition& position )
+AntBot* HeadlessAntWorld::createAnt( const AntPosition& position )
 {
-  if( m_scene )
-  {
-    /* The position passed in is the centre of the item so we need to cater for the
-     * offset to the item's top left corner. */
-    QPointF pointF( qreal( position.x() - boundingRect().width() / 2 ),
-                    qreal( position.y() - boundingRect().height() / 2 ) );
-    setPos( pointF );
-  }
+  return new HeadlessAnt( this, position );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsAntItem::showFoundGraphics()
+AntPheromone* HeadlessAntWorld::createPheromone( const AntPosition& position, AntPheromone::PheromoneType /*type*/ )
 {
-  QPixmap pixMap( ":/resources/foundorganism.png" );
-  setPixmap( pixMap.scaled( AntConfig::AntSize, AntConfig::AntSize, Qt::KeepAspectRatio ) );
+  return new HeadlessPheromone( position );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsAntItem::showForageGraphics()
+AntWorldTile* HeadlessAntWorld::createWorldTile( const AntPosition& position, AntWorldTile::TileType type )
 {
-  QPixmap pixMap( ":/resources/organism.png" );
-  setPixmap( pixMap.scaled( AntConfig::AntSize, AntConfig::AntSize, Qt::KeepAspectRatio ) );
+  HeadlessWorldTile* tile = new HeadlessWorldTile( position, type );
+
+  if( tile->tileType() == AntWorldTile::Spawn )
+  {
+    m_spawnPoints.push_back( position );
+  }
+
+  return tile;
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,71 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef HEADLESSANTWORLD_H
+#define HEADLESSANTWORLD_H
+
+#include "ants/antworld.h"
+#include "utils/antposition.h"
+
+#include <vector>
+
+/*! \brief A Qt-free AntWorld that creates AntBots, AntPheromones and AntWorldTiles without any
+ *  graphical representation.
+ *
+ *  Since nothing needs to be drawn, HeadlessAntWorld does not depend on a QApplication or
+ *  QGraphicsScene and "tick" can be called as fast as the sim logic allows (e.g. for batch
+ *  or server runs).
+ */
+
+class HeadlessAntWorld : public AntWorld
+{
+public:
+  /*! Constructor. */
+  HeadlessAntWorld();
+
+  /*! Clears and resets the world to a default state. */
+  void reset();
+
+  /*! Returns the centres of all the tiles that are spawn points. */
+  const std::vector< AntPosition >& spawnPoints() const;
+
+protected:
+  /*! Re-implemented from AntWorld. */
+  AntBot* createAnt( const AntPosition& position );
+
+  /*! Re-implemented from AntWorld. */
+  AntPheromone* createPheromone( const AntPosition& position, AntPheromone::PheromoneType type );
+
+  /*! Re-implemented from AntWorld. */
+  AntWorldTile* createWorldTile( const AntPosition& position, AntWorldTile::TileType type );
+
+private:
+  std::vector< AntPosition > m_spawnPoints;
+};
+
+#endif // HEADLESSANTWORLD_H
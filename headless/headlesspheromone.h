@@ -26,27 +26,23 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#ifndef GRAPHICSPHEROMONEITEM_H
-#define GRAPHICSPHEROMONEITEM_H
+#ifndef HEADLESSPHEROMONE_H
+#define HEADLESSPHEROMONE_H
 
 #include "ants/antpheromone.h"
-#include <QGraphicsEllipseItem>
 
-/*! \brief This class inherits from AntPheromone and is responsible for the graphical aspects of the pheromones. */
+/*! \brief This class inherits from AntPheromone and provides a pheromone without any graphical
+ *  representation (for use in batch runs where no QApplication is available). */
 
-class GraphicsPheromoneItem : public AntPheromone,
-                              public QGraphicsEllipseItem
+class HeadlessPheromone : public AntPheromone
 {
 public:
   /*! Constructor. */
-  explicit GraphicsPheromoneItem( const AntPosition& position, PheromoneType type, QGraphicsItem* parent = 0 );
+  explicit HeadlessPheromone( const AntPosition& position );
 
 protected:
-  /*! Re-implemented from AntPheromone. */
+  /*! Re-implemented from AntPheromone (does nothing). */
   virtual void updateGraphics();
-
-private:
-  qreal m_opacity;
 };
 
-#endif // GRAPHICSPHEROMONEITEM_H
+#endif // HEADLESSPHEROMONE_H
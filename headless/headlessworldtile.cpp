@@ -1,6 +1,6 @@
 /* Copyright (c) 2013 by William Hallatt.
  *
- * This file forms part of "OrganismSim".
+ * This file forms part of "AntSim".
  *
  * The official website for this project is <http://www.goblincoding.com> and,
  * although not compulsory, it would be appreciated if all works of whatever
@@ -17,7 +17,7 @@
  * version.
  *
  * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warrorganismy of MERCHANTABILITY or FITNESS
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
  * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
  *
  * You should have received a copy of the GNU General Public License along with
@@ -26,40 +26,19 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#include "graphicspheromoneitem.h"
-#include "utils/organismconfig.h"
-#include <QPen>
+#include "headlessworldtile.h"
 
 /*--------------------------------------------------------------------------------------*/
 
-GraphicsPheromoneItem::GraphicsPheromoneItem( const OrganismPosition& position, PheromoneType type, QGraphicsItem* parent )
-: OrganismPheromone( position, type ),
-  QGraphicsEllipseItem( parent ),
-  m_opacity( 1.0 )
+HeadlessWorldTile::HeadlessWorldTile( const AntPosition& position, TileType type )
+: AntWorldTile()
 {
-  setPen( QPen( Qt::darkGray ) );
-  setRect( position.x() - OrganismConfig::PheromoneSize / 2, position.y() - OrganismConfig::PheromoneSize / 2, OrganismConfig::PheromoneSize, OrganismConfig::PheromoneSize );
-
-  switch( type )
-  {
-    case Found:
-      setBrush( Qt::darkGreen );
-      break;
-    case Hazard:
-      setBrush( Qt::darkRed );
-      break;
-    case None:
-    default:
-      setBrush( Qt::white );
-  }
+  setCentre( position );
+  setTileType( type );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsPheromoneItem::updateGraphics()
-{
-  m_opacity = qreal( pheromoneStrength() );
-  setOpacity( m_opacity );
-}
+void HeadlessWorldTile::updateGraphics( AntWorldTile::TileType /*type*/ ) {}
 
-/*--------------------------------------------------------------------------------------*/
\ No newline at end of file
+/*--------------------------------------------------------------------------------------*/
@@ -1,6 +1,6 @@
 /* Copyright (c) 2013 by William Hallatt.
  *
- * This file forms part of "OrganismSim".
+ * This file forms part of "AntSim".
  *
  * The official website for this project is <http://www.goblincoding.com> and,
  * although not compulsory, it would be appreciated if all works of whatever
@@ -17,7 +17,7 @@
  * version.
  *
  * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warrorganismy of MERCHANTABILITY or FITNESS
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
  * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
  *
  * You should have received a copy of the GNU General Public License along with
@@ -26,27 +26,23 @@
  *                    <http://www.gnu.org/licenses/>
  */
 
-#ifndef GRAPHICSPHEROMONEITEM_H
-#define GRAPHICSPHEROMONEITEM_H
+#ifndef HEADLESSWORLDTILE_H
+#define HEADLESSWORLDTILE_H
 
-#include "organisms/organismpheromone.h"
-#include <QGraphicsEllipseItem>
+#include "ants/antworldtile.h"
 
-/*! \brief This class inherits from OrganismPheromone and is responsible for the graphical aspects of the pheromones. */
+/*! \brief This class inherits from AntWorldTile and provides a tile without any graphical
+ *  representation (for use in batch runs where no QApplication is available). */
 
-class GraphicsPheromoneItem : public OrganismPheromone,
-                              public QGraphicsEllipseItem
+class HeadlessWorldTile : public AntWorldTile
 {
 public:
   /*! Constructor. */
-  explicit GraphicsPheromoneItem( const OrganismPosition& position, PheromoneType type, QGraphicsItem* parent = 0 );
+  explicit HeadlessWorldTile( const AntPosition& position, TileType type );
 
 protected:
-  /*! Re-implemented from OrganismPheromone. */
-  virtual void updateGraphics();
-
-private:
-  qreal m_opacity;
+  /*! Re-implemented from AntWorldTile (does nothing). */
+  virtual void updateGraphics( TileType type );
 };
 
-#endif // GRAPHICSPHEROMONEITEM_H
+#endif // HEADLESSWORLDTILE_H
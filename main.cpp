@@ -27,10 +27,20 @@
  */
 
 #include "antsimmainwindow.h"
+#include "antsimbatch.h"
 #include <QApplication>
+#include <QCoreApplication>
 
 int main( int argc, char* argv[] )
 {
+  /* Batch runs don't need (or want) a window, see AntSimBatch. */
+  if( AntSimBatch::isBatchRun( argc, argv ) )
+  {
+    QCoreApplication a( argc, argv );
+    AntSimBatch batch;
+    return batch.run( a.arguments() );
+  }
+
   QApplication a( argc, argv );
   AntSimMainWindow w;
   w.show();
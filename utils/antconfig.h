@@ -40,6 +40,7 @@ namespace AntConfig
   const double AntSize = 18.0;          /*!< pixels (ant square size) */
   const double TileSize = 20.0;         /*!< pixels (world tile side) */
   const double PheromoneSize = 10.0;    /*!< pixels (pheromone diameter) */
+  const double DetailScale = 0.5;       /*!< view scale below which the world is drawn as per pixel summaries */
 
   /*! Instead of calculating probabilities in percentages, we assign an integer (chosen according
    *  to specific criteria) from within the probability range to the specific event (in this case
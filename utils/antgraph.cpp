@@ -29,64 +29,82 @@
 #include "antgraph.h"
 #include "antconfig.h"
 #include <algorithm>
+#include <cmath>
+
+/*--------------------------------------------------------------------------------------*/
+
+const int AntGraph::NotOnPath;
+const std::size_t AntGraph::MinNodeSlots;
 
 /*--------------------------------------------------------------------------------------*/
 
 AntGraph::AntGraph( const AntPosition& start )
 : m_maxNodesRemembered  ( 5 ),
-  m_nodes               ( 1, start ),
-  m_shortestPath        ( 1, start ),
-  m_shortestPathReversed(),
-  m_recentlyVisited     () {}
+  m_start               ( start ),
+  m_nodes               ( MinNodeSlots, NodeSlot{ 0, NotOnPath } ),
+  m_nodeCount           ( 0 ),
+  m_shortestPath        ( start ),
+  m_foundPath           ( start ),
+  m_recentlyVisited     ( m_maxNodesRemembered ),
+  m_rememberedCount     ( 0 ),
+  m_oldestRemembered    ( 0 )
+{
+  m_shortestPath.append( start );
+  setPathIndex( nodeKey( start ), 0 );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGraph::reset( const AntPosition& start )
+{
+  m_start = start;
+  std::fill( std::begin( m_nodes ), std::end( m_nodes ), NodeSlot{ 0, NotOnPath } );
+  m_nodeCount = 0;
+  m_shortestPath.reset( start );
+  m_foundPath.reset( start );
+  m_rememberedCount = 0;
+  m_oldestRemembered = 0;
+
+  m_shortestPath.append( start );
+  setPathIndex( nodeKey( start ), 0 );
+}
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntGraph::addNode( const AntPosition& position )
 {
-  /* Keep track of two separate lists of nodes, the first is a list of ALL the nodes
-   * ever visited and the second that of the nodes on the current shortest path.  The
-   * reason for keeping the first list is that, even though ants may double back on
-   * themselves, we'd still like to know if the nodes they travel along on the next
-   * "iteration" of their travels has been previously visited in order to favour nodes
-   * that have never been visited at all (e.g. go down a new fork, rather than simply
-   * traversing the previous loop that ended in failure). */
-  if( std::none_of( std::begin( m_nodes ), std::end( m_nodes ),
-                    [ &position ]( AntPosition pos ) { return pos == position; } ) )
-  {
-    m_nodes.push_back( position );
-  }
-  else
+  /* The node table maps the nodes on the current shortest path to their index on it, so
+   * that neither the membership test nor finding the loop involves a search.  Nodes that
+   * drop off the path are removed from the table again, which keeps its size bounded by
+   * the length of the path rather than the number of nodes ever visited (and the table
+   * only allocates when the path grows longer than it has ever been). */
+  NodeKey key = nodeKey( position );
+  int loopStart = pathIndex( key );
+
+  if( loopStart != NotOnPath )
   {
-    /* If a node is already in the list, it means the ant has looped back on itself,
+    /* If a node is already on the path, it means the ant has looped back on itself,
      * in other words, all the nodes encountered since we last visited this particular
      * node has been for naught and can be deleted.  This way, we ensure that the route
      * the ant travels between the starting point and the final destination remains the
      * shortest route for its particular graph. */
-    auto it = std::find( std::begin( m_shortestPath ), std::end( m_shortestPath ), position );
+    for( auto i = m_shortestPath.end(); i.index() > loopStart; )
+    {
+      --i;
+      removeNode( nodeKey( i.column(), i.row() ) );
+    }
 
-    /* Remove the pointless nodes (the loop) from the vector. */
-    m_shortestPath.resize( it - std::begin( m_shortestPath ) );
+    /* Remove the pointless nodes (the loop) from the path. */
+    m_shortestPath.truncate( loopStart );
   }
 
   /* Regardless of what happens, add the node to the end of the shortest path (if the
-   * node had been previously encountered, it would have been removed in the "else" part
-   * above and will need to be re-added). */
-  m_shortestPath.push_back( position );
+   * node had been previously encountered, it would have been removed above and will
+   * need to be re-added). */
+  setPathIndex( key, m_shortestPath.size() );
+  m_shortestPath.append( position );
 
-  /* We don't want the same position to occur multiple times in the recently
-   * visited list since this will skew the results when "recentlyVisited" is called. */
-  if( !recentlyVisited( position ) )
-  {
-    if( m_recentlyVisited.size() < m_maxNodesRemembered )
-    {
-      m_recentlyVisited.push_back( position );
-    }
-    else
-    {
-      m_recentlyVisited.pop_front();
-      m_recentlyVisited.push_back( position );
-    }
-  }
+  remember( key );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -94,39 +112,160 @@ void AntGraph::addNode( const AntPosition& position )
 void AntGraph::setFoundTarget( const AntPosition& position )
 {
   addNode( position );
-  reverseShortestPath();
+  m_foundPath = m_shortestPath;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-const std::vector< AntPosition >& AntGraph::shortestPath() const
+const AntPath& AntGraph::shortestPath() const
 {
-  return m_shortestPathReversed;
+  return m_foundPath;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 bool AntGraph::recentlyVisited( const AntPosition& position ) const
 {
-  return std::any_of( std::begin( m_recentlyVisited ), std::end( m_recentlyVisited ),
-                      [ &position ]( AntPosition pos ) { return pos == position; } );
+  return remembered( nodeKey( position ) );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
 void AntGraph::setMaxNodesRemembered( unsigned int maxNodesRemembered )
 {
+  if( maxNodesRemembered == m_maxNodesRemembered ) return;
+
+  /* Lay the used part of the ring buffer out from oldest to newest (until it is full, it
+   * already is), keeping the newest nodes that fit at the front of the new buffer. */
+  auto used = std::begin( m_recentlyVisited ) + m_rememberedCount;
+  std::rotate( std::begin( m_recentlyVisited ), std::begin( m_recentlyVisited ) + m_oldestRemembered, used );
+
+  std::vector< NodeKey > recentlyVisited( maxNodesRemembered );
+  auto kept = std::min( maxNodesRemembered, m_rememberedCount );
+  std::copy( used - kept, used, std::begin( recentlyVisited ) );
+
+  m_recentlyVisited.swap( recentlyVisited );
   m_maxNodesRemembered = maxNodesRemembered;
-  m_recentlyVisited.resize( m_maxNodesRemembered );
+  m_rememberedCount = kept;
+  m_oldestRemembered = ( kept < maxNodesRemembered ) ? kept : 0;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGraph::remember( NodeKey key )
+{
+  /* We don't want the same position to occur multiple times in the recently
+   * visited list since this will skew the results when "recentlyVisited" is called. */
+  if( m_maxNodesRemembered > 0 && !remembered( key ) )
+  {
+    m_recentlyVisited[ m_oldestRemembered ] = key;
+    m_oldestRemembered = ( m_oldestRemembered + 1 ) % m_maxNodesRemembered;
+    if( m_rememberedCount < m_maxNodesRemembered ) ++m_rememberedCount;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntGraph::remembered( NodeKey key ) const
+{
+  /* A branch-free comparison against every used slot so that the compiler can turn this
+   * into a handful of vector compares. */
+  const NodeKey* keys = m_recentlyVisited.data();
+  unsigned int matches = 0;
+
+  for( unsigned int i = 0; i < m_rememberedCount; ++i ) matches |= ( keys[ i ] == key );
+
+  return matches != 0;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntGraph::NodeKey AntGraph::nodeKey( const AntPosition& position ) const
+{
+  return nodeKey( static_cast< int >( std::lround( ( position.x() - m_start.x() ) / AntConfig::TileSize ) ),
+                  static_cast< int >( std::lround( ( position.y() - m_start.y() ) / AntConfig::TileSize ) ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntGraph::NodeKey AntGraph::nodeKey( int column, int row )
+{
+  return ( static_cast< NodeKey >( static_cast< std::uint32_t >( column ) ) << 32 ) | static_cast< std::uint32_t >( row );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntGraph::pathIndex( NodeKey key ) const
+{
+  const std::size_t mask = m_nodes.size() - 1;
+
+  for( std::size_t slot = homeSlot( key ); m_nodes[ slot ].index != NotOnPath; slot = ( slot + 1 ) & mask )
+  {
+    if( m_nodes[ slot ].key == key ) return m_nodes[ slot ].index;
+  }
+
+  return NotOnPath;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGraph::setPathIndex( NodeKey key, int index )
+{
+  /* Keep the table at most half full so that probe sequences stay short. */
+  if( 2 * ( m_nodeCount + 1 ) > m_nodes.size() )
+  {
+    std::vector< NodeSlot > nodes( 2 * m_nodes.size(), NodeSlot{ 0, NotOnPath } );
+    nodes.swap( m_nodes );
+    m_nodeCount = 0;
+
+    for( const NodeSlot& node : nodes ) if( node.index != NotOnPath ) setPathIndex( node.key, node.index );
+  }
+
+  const std::size_t mask = m_nodes.size() - 1;
+  std::size_t slot = homeSlot( key );
+
+  while( m_nodes[ slot ].index != NotOnPath && m_nodes[ slot ].key != key ) slot = ( slot + 1 ) & mask;
+
+  if( m_nodes[ slot ].index == NotOnPath ) ++m_nodeCount;
+  m_nodes[ slot ] = NodeSlot{ key, index };
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGraph::removeNode( NodeKey key )
+{
+  const std::size_t mask = m_nodes.size() - 1;
+  std::size_t slot = homeSlot( key );
+
+  while( m_nodes[ slot ].index != NotOnPath && m_nodes[ slot ].key != key ) slot = ( slot + 1 ) & mask;
+
+  if( m_nodes[ slot ].index == NotOnPath ) return;   // not in the table
+
+  /* Close the gap by shifting back the nodes further along the probe sequence that may
+   * no longer be found otherwise (no tombstones needed). */
+  for( std::size_t next = ( slot + 1 ) & mask; m_nodes[ next ].index != NotOnPath; next = ( next + 1 ) & mask )
+  {
+    std::size_t home = homeSlot( m_nodes[ next ].key );
+
+    /* The node at "next" may move to "slot" unless its home lies cyclically in ( slot, next ]. */
+    if( ( ( next - home ) & mask ) >= ( ( next - slot ) & mask ) )
+    {
+      m_nodes[ slot ] = m_nodes[ next ];
+      slot = next;
+    }
+  }
+
+  m_nodes[ slot ] = NodeSlot{ 0, NotOnPath };
+  --m_nodeCount;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void AntGraph::reverseShortestPath()
+std::size_t AntGraph::homeSlot( NodeKey key ) const
 {
-  m_shortestPathReversed.clear();
-  m_shortestPathReversed.resize( m_shortestPath.size() );
-  std::reverse_copy( std::begin( m_shortestPath ), std::end( m_shortestPath ), std::begin( m_shortestPathReversed ) );
+  /* Keys pack ( column, row ) into the high and low halves, mix them before masking. */
+  std::uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+  return static_cast< std::size_t >( hash ^ ( hash >> 32 ) ) & ( m_nodes.size() - 1 );
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -30,8 +30,9 @@
 #define ANTGRAPH_H
 
 #include "antposition.h"
+#include "antpath.h"
 #include <vector>
-#include <list>
+#include <cstdint>
 
 /*! \brief This class represents an AntBot's internal search graph.
  *
@@ -52,43 +53,95 @@ public:
    *  encountered until now is removed from the node list). */
   void addNode( const AntPosition& position );
 
-  /*! Sets the target (food) node. A call to this function triggers the reversal of
-   *  the traversed shortest path.
+  /*! Sets the target (food) node. A call to this function records the traversed
+   *  shortest path for the ant's return journey.
    *
    *  \sa shortestPath */
   void setFoundTarget( const AntPosition& position );
 
-  /*! Returns the shortest path between target and source (first node will correspond to the
-   *  target and the last to the starting point). A target node must have been
-   *  specified or else an empty vector is returned.
+  /*! Returns the shortest path between source and target (first node will correspond to the
+   *  starting point and the last to the target, i.e. an ant returning to its source walks it
+   *  backwards). A target node must have been specified or else an empty path is returned.
    *
    *  \sa setFoundTarget */
-  const std::vector< AntPosition >& shortestPath() const;
+  const AntPath& shortestPath() const;
 
   /*! Returns true if "position" was one of "x" number of last
-   *  nodes visited (see antconfig.h for the MaxNodesRemembered value). */
+   *  nodes visited (see setMaxNodesRemembered). */
   bool recentlyVisited( const AntPosition& position ) const;
 
+  /*! Returns the graph to the state it was constructed in with "start" as the goal node
+   *  (the number of nodes remembered is kept, as is the memory allocated so far: the node
+   *  table and ring buffer are cleared in place, so this function doesn't allocate). */
+  void reset( const AntPosition& start );
+
   /*! Sets the maximum number of nodes that AntGraph should consider when determining
-   *  whether a position has been recently visited (default 5).
+   *  whether a position has been recently visited (default 5).  The most recently
+   *  visited nodes are retained when the number is changed.
    *
    *  \sa recentlyVisited
    */
   void setMaxNodesRemembered( unsigned int maxNodesRemembered );
 
 private:
-  /*! Reverses the shortest path for the ant's return journey.
+  using NodeKey = std::uint64_t;
+
+  /*! Adds "key" to the ring buffer of recently visited nodes (unless it is already there),
+   *  overwriting the oldest entry once the buffer is full.
    *
-   *  \sa shortestPath */
-  void reverseShortestPath();
+   *  \sa recentlyVisited */
+  void remember( NodeKey key );
+
+  /*! Returns true if "key" is in the ring buffer of recently visited nodes. */
+  bool remembered( NodeKey key ) const;
+
+  /*! Returns the index on the shortest path of the node with "key" (or NotOnPath). */
+  int pathIndex( NodeKey key ) const;
+
+  /*! Records that the node with "key" is at "index" on the shortest path (growing the node
+   *  table if it is getting full). */
+  void setPathIndex( NodeKey key, int index );
+
+  /*! Removes the node with "key" from the node table (if it is there). */
+  void removeNode( NodeKey key );
+
+  /*! Returns the node table slot at which the search for "key" starts. */
+  std::size_t homeSlot( NodeKey key ) const;
+
+  /*! Returns a compact key identifying the tile at "position".  Since ants move from tile
+   *  centre to tile centre, every node lies on the grid of AntConfig::TileSize spaced points
+   *  anchored at the start node and the key simply packs the node's ( column, row ) offset
+   *  from the start into 32 bits each (i.e. every tile an int can address has its own key). */
+  NodeKey nodeKey( const AntPosition& position ) const;
+
+  /*! Returns the key of the node at ( "column", "row" ) tiles from the start node. */
+  static NodeKey nodeKey( int column, int row );
 
 private:
+  /*! A node on the shortest path (or an empty slot if "index" is NotOnPath, every key is
+   *  a valid node so none can be set aside to mark empty slots). */
+  struct NodeSlot
+  {
+    NodeKey key;
+    int index;
+  };
+
+  /*! Marks a visited node that is not (or no longer) on the shortest path. */
+  static const int NotOnPath = -1;
+
+  /*! The initial number of node table slots (must be a power of two). */
+  static const std::size_t MinNodeSlots = 64;
+
   unsigned int m_maxNodesRemembered;
 
-  std::vector< AntPosition > m_nodes;
-  std::vector< AntPosition > m_shortestPath;
-  std::vector< AntPosition > m_shortestPathReversed;
-  std::list< AntPosition > m_recentlyVisited;
+  AntPosition m_start;
+  std::vector< NodeSlot > m_nodes;                      // open addressing (linear probing) table of the nodes on m_shortestPath
+  std::size_t m_nodeCount;                              // used slots in m_nodes
+  AntPath m_shortestPath;                               // nodes are addressed relative to m_start
+  AntPath m_foundPath;                                  // m_shortestPath as it was when the target was found
+  std::vector< NodeKey > m_recentlyVisited;             // ring buffer of m_maxNodesRemembered keys
+  unsigned int m_rememberedCount;                       // used slots in m_recentlyVisited (filled from the front)
+  unsigned int m_oldestRemembered;                      // next slot to overwrite
 };
 
 #endif // ANTGRAPH_H
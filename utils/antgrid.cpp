@@ -0,0 +1,123 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antgrid.h"
+#include <algorithm>
+
+/*--------------------------------------------------------------------------------------*/
+
+const int AntGrid::Empty;
+
+/*--------------------------------------------------------------------------------------*/
+
+AntGrid::AntGrid()
+: m_firstRow   ( 0 ),
+  m_firstColumn( 0 ),
+  m_rows       ( 0 ),
+  m_columns    ( 0 ),
+  m_cells      () {}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGrid::clear()
+{
+  m_firstRow = 0;
+  m_firstColumn = 0;
+  m_rows = 0;
+  m_columns = 0;
+  m_cells.clear();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGrid::insert( int row, int column, int value )
+{
+  if( !contains( row, column ) ) grow( row, column );
+  m_cells[ ( row - m_firstRow ) * m_columns + ( column - m_firstColumn ) ] = value;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntGrid::value( int row, int column ) const
+{
+  return contains( row, column ) ? m_cells[ ( row - m_firstRow ) * m_columns + ( column - m_firstColumn ) ] : Empty;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntGrid::contains( int row, int column ) const
+{
+  return row >= m_firstRow && row < m_firstRow + m_rows &&
+         column >= m_firstColumn && column < m_firstColumn + m_columns;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntGrid::grow( int row, int column )
+{
+  if( m_cells.empty() )
+  {
+    m_firstRow = row;
+    m_firstColumn = column;
+    m_rows = 1;
+    m_columns = 1;
+    m_cells.assign( 1, Empty );
+    return;
+  }
+
+  /* Grow by (at least) the current extent in whichever direction is required so that
+   * tiles registered one row or column at a time don't trigger a re-layout each time. */
+  int firstRow = m_firstRow;
+  int lastRow = m_firstRow + m_rows - 1;
+  int firstColumn = m_firstColumn;
+  int lastColumn = m_firstColumn + m_columns - 1;
+
+  if( row < firstRow ) firstRow = std::min( row, firstRow - m_rows );
+  if( row > lastRow ) lastRow = std::max( row, lastRow + m_rows );
+  if( column < firstColumn ) firstColumn = std::min( column, firstColumn - m_columns );
+  if( column > lastColumn ) lastColumn = std::max( column, lastColumn + m_columns );
+
+  int rows = lastRow - firstRow + 1;
+  int columns = lastColumn - firstColumn + 1;
+  std::vector< int > cells( rows * columns, Empty );
+
+  for( int r = 0; r < m_rows; ++r )
+  {
+    auto source = std::begin( m_cells ) + r * m_columns;
+    auto target = std::begin( cells ) + ( r + m_firstRow - firstRow ) * columns + ( m_firstColumn - firstColumn );
+    std::copy( source, source + m_columns, target );
+  }
+
+  m_firstRow = firstRow;
+  m_firstColumn = firstColumn;
+  m_rows = rows;
+  m_columns = columns;
+  m_cells.swap( cells );
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,81 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTGRID_H
+#define ANTGRID_H
+
+#include <vector>
+
+/*! \brief A dense, integer-addressed 2D index that maps ( row, column ) pairs to integer values
+ *  (typically indices into a registry of world objects).
+ *
+ *  The grid grows to accommodate whatever coordinates are inserted (negative rows and
+ *  columns are allowed) and always grows by at least its current extent in the direction
+ *  required, so that populating it cell by cell remains amortised constant time.  Look-ups
+ *  are constant time.
+ */
+
+class AntGrid
+{
+public:
+  /*! The value returned for cells that have not been populated. */
+  static const int Empty = -1;
+
+  /*! Constructs an empty grid. */
+  AntGrid();
+
+  /*! Removes all cells from the grid. */
+  void clear();
+
+  /*! Sets the value of the cell at ( "row", "column" ), growing the grid if necessary.
+   *
+   *  \sa value */
+  void insert( int row, int column, int value );
+
+  /*! Returns the value stored at ( "row", "column" ) or "Empty" if the cell is
+   *  outside the grid or has not been populated.
+   *
+   *  \sa insert */
+  int value( int row, int column ) const;
+
+private:
+  /*! Returns "true" if ( "row", "column" ) falls within the grid's current bounds. */
+  bool contains( int row, int column ) const;
+
+  /*! Re-lays the grid out so that it covers ( "row", "column" ). */
+  void grow( int row, int column );
+
+private:
+  int m_firstRow;
+  int m_firstColumn;
+  int m_rows;
+  int m_columns;
+  std::vector< int > m_cells;   // row major
+};
+
+#endif // ANTGRID_H
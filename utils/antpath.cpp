@@ -0,0 +1,311 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antpath.h"
+#include "antconfig.h"
+#include <cmath>
+#include <cstdlib>
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::const_iterator::const_iterator()
+: m_path  ( nullptr ),
+  m_index ( 0 ),
+  m_column( 0 ),
+  m_row   ( 0 ) {}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::const_iterator::const_iterator( const AntPath* path, int index, int column, int row )
+: m_path  ( path ),
+  m_index ( index ),
+  m_column( column ),
+  m_row   ( row ) {}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPosition AntPath::const_iterator::operator*() const
+{
+  return m_path->position( m_column, m_row );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntPath::const_iterator::column() const
+{
+  return m_column;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntPath::const_iterator::row() const
+{
+  return m_row;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntPath::const_iterator::index() const
+{
+  return m_index;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::const_iterator& AntPath::const_iterator::operator++()
+{
+  /* The "end" iterator's coordinates are meaningless, don't step into it. */
+  if( ++m_index < m_path->size() ) m_path->stepForward( m_index, m_column, m_row );
+  return *this;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::const_iterator& AntPath::const_iterator::operator--()
+{
+  /* Stepping back from "end" lands on the last node. */
+  if( m_index == m_path->size() )
+  {
+    m_column = m_path->m_lastColumn;
+    m_row = m_path->m_lastRow;
+  }
+  else
+  {
+    m_path->stepBack( m_index, m_column, m_row );
+  }
+
+  --m_index;
+  return *this;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntPath::const_iterator::operator==( const const_iterator& other ) const
+{
+  return m_path == other.m_path && m_index == other.m_index;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntPath::const_iterator::operator!=( const const_iterator& other ) const
+{
+  return !( *this == other );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::AntPath( const AntPosition& origin )
+: m_origin     ( origin ),
+  m_size       ( 0 ),
+  m_firstColumn( 0 ),
+  m_firstRow   ( 0 ),
+  m_lastColumn ( 0 ),
+  m_lastRow    ( 0 ),
+  m_steps      (),
+  m_jumps      () {}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntPath::size() const
+{
+  return m_size;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool AntPath::empty() const
+{
+  return m_size == 0;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::append( const AntPosition& position )
+{
+  int column = static_cast< int >( std::lround( ( position.x() - m_origin.x() ) / AntConfig::TileSize ) );
+  int row = static_cast< int >( std::lround( ( position.y() - m_origin.y() ) / AntConfig::TileSize ) );
+
+  if( m_size == 0 )
+  {
+    m_firstColumn = column;
+    m_firstRow = row;
+    m_steps.push_back( 0 );   // the first node has no step, but shares a byte with the next three
+  }
+  else
+  {
+    int columnDelta = column - m_lastColumn;
+    int rowDelta = row - m_lastRow;
+
+    if( std::abs( columnDelta ) + std::abs( rowDelta ) == 1 )
+    {
+      if( columnDelta == 1 )       setDirection( m_size, ColumnAfter );
+      else if( columnDelta == -1 ) setDirection( m_size, ColumnBefore );
+      else if( rowDelta == 1 )     setDirection( m_size, RowAfter );
+      else                         setDirection( m_size, RowBefore );
+    }
+    else
+    {
+      setDirection( m_size, ColumnAfter );   // unused, keeps the step codes contiguous
+      Jump jump = { m_size, m_lastColumn, m_lastRow, column, row };
+      m_jumps.push_back( jump );
+    }
+  }
+
+  m_lastColumn = column;
+  m_lastRow = row;
+  ++m_size;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::clear()
+{
+  truncate( 0 );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::reset( const AntPosition& origin )
+{
+  m_origin = origin;
+  clear();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::truncate( int size )
+{
+  if( size >= m_size ) return;
+
+  if( size <= 0 )
+  {
+    m_size = 0;
+    m_steps.clear();
+    m_jumps.clear();
+    return;
+  }
+
+  /* Walk the last node back to what will be the new last node (which costs as many steps
+   * as are removed, i.e. the work is amortised over the appends that added them). */
+  for( int index = m_size - 1; index >= size; --index ) stepBack( index, m_lastColumn, m_lastRow );
+
+  while( !m_jumps.empty() && m_jumps.back().index >= size ) m_jumps.pop_back();
+
+  m_size = size;
+  m_steps.resize( ( m_size + 3 ) / 4 );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::const_iterator AntPath::begin() const
+{
+  return const_iterator( this, 0, m_firstColumn, m_firstRow );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPath::const_iterator AntPath::end() const
+{
+  return const_iterator( this, m_size, m_lastColumn, m_lastRow );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntPath::direction( int index ) const
+{
+  return ( m_steps[ index / 4 ] >> ( ( index % 4 ) * 2 ) ) & 0x3;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::setDirection( int index, int direction )
+{
+  if( index % 4 == 0 ) m_steps.push_back( 0 );
+
+  int shift = ( index % 4 ) * 2;
+  m_steps[ index / 4 ] = static_cast< std::uint8_t >( ( m_steps[ index / 4 ] & ~( 0x3 << shift ) ) | ( direction << shift ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const AntPath::Jump* AntPath::jumpTo( int index ) const
+{
+  /* There is hardly ever more than one jump on a path. */
+  for( auto& jump : m_jumps ) if( jump.index == index ) return &jump;
+  return nullptr;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::stepForward( int index, int& column, int& row ) const
+{
+  if( const Jump* jump = jumpTo( index ) )
+  {
+    column = jump->toColumn;
+    row = jump->toRow;
+    return;
+  }
+
+  switch( direction( index ) )
+  {
+    case ColumnAfter:  ++column; break;
+    case ColumnBefore: --column; break;
+    case RowAfter:     ++row;    break;
+    case RowBefore:    --row;    break;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntPath::stepBack( int index, int& column, int& row ) const
+{
+  if( const Jump* jump = jumpTo( index ) )
+  {
+    column = jump->fromColumn;
+    row = jump->fromRow;
+    return;
+  }
+
+  switch( direction( index ) )
+  {
+    case ColumnAfter:  --column; break;
+    case ColumnBefore: ++column; break;
+    case RowAfter:     --row;    break;
+    case RowBefore:    ++row;    break;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntPosition AntPath::position( int column, int row ) const
+{
+  return AntPosition( m_origin.x() + column * AntConfig::TileSize,
+                      m_origin.y() + row * AntConfig::TileSize );
+}
+
+/*--------------------------------------------------------------------------------------*/
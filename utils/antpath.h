@@ -0,0 +1,173 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTPATH_H
+#define ANTPATH_H
+
+#include "antposition.h"
+#include <vector>
+#include <cstdint>
+#include <iterator>
+
+/*! \brief A compact representation of a path through the world grid.
+ *
+ *  Since ants move between 4-connected neighbouring tiles, a path is stored as its first
+ *  node plus a 2-bit direction code for every step that follows (rather than as a full
+ *  AntPosition per node).  Nodes are addressed by their integer ( column, row ) offset
+ *  from the first node (AntConfig::TileSize apart) and their positions are reconstructed
+ *  on the fly when iterating.
+ *
+ *  The odd step that isn't between adjacent tiles (e.g. when an ant that has returned to
+ *  its nest picks up foraging where its path left off) is recorded separately, which
+ *  keeps the common case at 2 bits per step without restricting what can be stored.
+ */
+
+class AntPath
+{
+public:
+  /*! \brief A bidirectional iterator over the positions of the nodes on a path. */
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = AntPosition;
+    using difference_type = int;
+    using pointer = const AntPosition*;
+    using reference = AntPosition;
+
+    /*! Constructs an iterator that does not refer to any path. */
+    const_iterator();
+
+    /*! Returns the position of the current node. */
+    AntPosition operator*() const;
+
+    /*! Returns the current node's column offset from the first node. */
+    int column() const;
+
+    /*! Returns the current node's row offset from the first node. */
+    int row() const;
+
+    /*! Returns the current node's index on the path. */
+    int index() const;
+
+    const_iterator& operator++();
+    const_iterator& operator--();
+    bool operator==( const const_iterator& other ) const;
+    bool operator!=( const const_iterator& other ) const;
+
+  private:
+    friend class AntPath;
+    const_iterator( const AntPath* path, int index, int column, int row );
+
+    const AntPath* m_path;
+    int m_index;
+    int m_column;
+    int m_row;
+  };
+
+  /*! Constructs an empty path whose nodes will be addressed relative to "origin" (the
+   *  origin need not be the first node, but all nodes must lie on the grid it anchors). */
+  explicit AntPath( const AntPosition& origin = AntPosition() );
+
+  /*! Returns the number of nodes on the path. */
+  int size() const;
+
+  /*! Returns "true" if the path has no nodes. */
+  bool empty() const;
+
+  /*! Appends the node at "position" to the end of the path. */
+  void append( const AntPosition& position );
+
+  /*! Removes all nodes from the path. */
+  void clear();
+
+  /*! Removes all nodes from the path and re-anchors it at "origin" (the path keeps the
+   *  memory it has allocated so far, see AntGraph::reset). */
+  void reset( const AntPosition& origin );
+
+  /*! Shortens the path to its first "size" nodes (does nothing if the path
+   *  is not longer than "size"). */
+  void truncate( int size );
+
+  /*! Returns an iterator pointing to the first node. */
+  const_iterator begin() const;
+
+  /*! Returns an iterator pointing past the last node (decrement it to iterate
+   *  backwards from the last node). */
+  const_iterator end() const;
+
+private:
+  /*! A step between non-adjacent nodes ("index" is that of the node stepped to). */
+  struct Jump
+  {
+    int index;
+    int fromColumn;
+    int fromRow;
+    int toColumn;
+    int toRow;
+  };
+
+  /*! Direction codes (2 bits each). */
+  enum Direction
+  {
+    ColumnAfter,
+    ColumnBefore,
+    RowAfter,
+    RowBefore
+  };
+
+  /*! Returns the direction code of the step to the node at "index" (index > 0). */
+  int direction( int index ) const;
+
+  /*! Sets the direction code of the step to the node at "index" (index > 0). */
+  void setDirection( int index, int direction );
+
+  /*! Returns the jump to the node at "index" or nullptr if that step is to an adjacent node. */
+  const Jump* jumpTo( int index ) const;
+
+  /*! Moves ( "column", "row" ) from the node at "index" - 1 to the node at "index". */
+  void stepForward( int index, int& column, int& row ) const;
+
+  /*! Moves ( "column", "row" ) from the node at "index" to the node at "index" - 1. */
+  void stepBack( int index, int& column, int& row ) const;
+
+  /*! Returns the position of the node at ( "column", "row" ). */
+  AntPosition position( int column, int row ) const;
+
+private:
+  AntPosition m_origin;
+  int m_size;
+  int m_firstColumn;
+  int m_firstRow;
+  int m_lastColumn;
+  int m_lastRow;
+  std::vector< std::uint8_t > m_steps;   // 4 steps per byte
+  std::vector< Jump > m_jumps;           // ordered by index
+};
+
+#endif // ANTPATH_H
@@ -0,0 +1,104 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antrandom.h"
+
+/*--------------------------------------------------------------------------------------*/
+
+namespace
+{
+  const std::uint64_t Gamma = 0x9e3779b97f4a7c15ULL;   // golden ratio increment (SplitMix64)
+
+  /* SplitMix64's finaliser: a bijective mix of all 64 input bits. */
+  std::uint64_t mix( std::uint64_t z )
+  {
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const int AntRandom::BlockSize;
+
+/*--------------------------------------------------------------------------------------*/
+
+AntRandom::AntRandom( std::uint64_t seed, std::uint64_t stream )
+: m_key    ( 0 ),
+  m_counter( 0 ),
+  m_block  (),
+  m_next   ( BlockSize )
+{
+  AntRandom::seed( seed, stream );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntRandom::seed( std::uint64_t seed, std::uint64_t stream )
+{
+  m_key = mix( mix( seed ) + stream * Gamma );
+  m_counter = 0;
+  m_next = BlockSize;   // discard whatever is left of the current block
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+std::uint32_t AntRandom::next()
+{
+  if( m_next == BlockSize )
+  {
+    generate( m_block, BlockSize );
+    m_next = 0;
+  }
+
+  return m_block[ m_next++ ];
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntRandom::bounded( int range )
+{
+  /* Multiply-shift rather than modulo: cheaper and uses the high (best mixed) bits. */
+  return static_cast< int >( ( static_cast< std::uint64_t >( next() ) * static_cast< std::uint32_t >( range ) ) >> 32 );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntRandom::generate( std::uint32_t* values, int count )
+{
+  /* No value depends on the previous one, so this loop is free to be vectorised. */
+  for( int i = 0; i < count; ++i )
+  {
+    values[ i ] = static_cast< std::uint32_t >( mix( m_key + ( m_counter + i ) * Gamma ) >> 32 );
+  }
+
+  m_counter += count;
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,74 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTRANDOM_H
+#define ANTRANDOM_H
+
+#include <cstdint>
+
+/*! \brief A seedable, counter-based pseudo random number generator.
+ *
+ *  Every value is a pure function of ( seed, stream, counter ): the counter is mixed with
+ *  a key derived from the seed and the stream number by a SplitMix64 finaliser.  Streams
+ *  are therefore independent of each other and of the order in which they are drawn from,
+ *  which means that a sim using one stream per AntBot reproduces exactly for a given seed,
+ *  however (and on however many threads) the ants are updated.
+ *
+ *  Values are generated in blocks of "BlockSize" (see "generate") and handed out one at
+ *  a time by "next".
+ */
+
+class AntRandom
+{
+public:
+  /*! The number of values generated at a time. */
+  static const int BlockSize = 16;
+
+  /*! Constructs the generator for "stream" of "seed". */
+  explicit AntRandom( std::uint64_t seed = 0, std::uint64_t stream = 0 );
+
+  /*! Restarts the generator at the beginning of "stream" of "seed". */
+  void seed( std::uint64_t seed, std::uint64_t stream );
+
+  /*! Returns the next 32-bit value in the stream. */
+  std::uint32_t next();
+
+  /*! Returns the next value in the stream scaled to the range [ 0, "range" ) ("range" must be > 0). */
+  int bounded( int range );
+
+  /*! Fills "values" with the next "count" values in the stream. */
+  void generate( std::uint32_t* values, int count );
+
+private:
+  std::uint64_t m_key;
+  std::uint64_t m_counter;
+  std::uint32_t m_block[ BlockSize ];
+  int m_next;
+};
+
+#endif // ANTRANDOM_H
@@ -0,0 +1,163 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "antthreadpool.h"
+#include <algorithm>
+
+/*--------------------------------------------------------------------------------------*/
+
+AntThreadPool::AntThreadPool( int threadCount )
+: m_workers    (),
+  m_mutex      (),
+  m_started    (),
+  m_finished   (),
+  m_task       ( nullptr ),
+  m_count      ( 0 ),
+  m_chunkSize  ( 1 ),
+  m_nextChunk  ( 0 ),
+  m_busyWorkers( 0 ),
+  m_generation ( 0 ),
+  m_stopping   ( false )
+{
+  setThreadCount( threadCount );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntThreadPool::~AntThreadPool()
+{
+  stop();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntThreadPool::setThreadCount( int threadCount )
+{
+  if( threadCount < 1 ) threadCount = 1;
+  if( threadCount == this->threadCount() ) return;
+
+  stop();
+
+  m_stopping = false;
+  for( int i = 1; i < threadCount; ++i ) m_workers.push_back( std::thread( &AntThreadPool::work, this, m_generation ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int AntThreadPool::threadCount() const
+{
+  return static_cast< int >( m_workers.size() ) + 1;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntThreadPool::run( int count, int chunkSize, const std::function< void( int, int ) >& task )
+{
+  if( count <= 0 ) return;
+  if( chunkSize < 1 ) chunkSize = 1;
+
+  /* Not worth waking anyone up for. */
+  if( m_workers.empty() || count <= chunkSize )
+  {
+    for( int begin = 0; begin < count; begin += chunkSize ) task( begin, std::min( begin + chunkSize, count ) );
+    return;
+  }
+
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_task = &task;
+    m_count = count;
+    m_chunkSize = chunkSize;
+    m_nextChunk = 0;
+    m_busyWorkers = static_cast< int >( m_workers.size() );
+    ++m_generation;
+  }
+
+  m_started.notify_all();
+
+  /* The calling thread pitches in rather than idling until the workers are done. */
+  processChunks();
+
+  std::unique_lock< std::mutex > lock( m_mutex );
+  m_finished.wait( lock, [ this ]{ return m_busyWorkers == 0; } );
+  m_task = nullptr;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntThreadPool::work( unsigned int generation )
+{
+  for( ;; )
+  {
+    {
+      std::unique_lock< std::mutex > lock( m_mutex );
+      m_started.wait( lock, [ & ]{ return m_stopping || m_generation != generation; } );
+      if( m_stopping ) return;
+      generation = m_generation;
+    }
+
+    processChunks();
+
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      --m_busyWorkers;
+    }
+
+    m_finished.notify_one();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntThreadPool::processChunks()
+{
+  for( ;; )
+  {
+    int begin = m_nextChunk.fetch_add( 1 ) * m_chunkSize;
+    if( begin >= m_count ) return;
+
+    ( *m_task )( begin, std::min( begin + m_chunkSize, m_count ) );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void AntThreadPool::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_stopping = true;
+  }
+
+  m_started.notify_all();
+
+  for( auto& worker : m_workers ) worker.join();
+  m_workers.clear();
+}
+
+/*--------------------------------------------------------------------------------------*/
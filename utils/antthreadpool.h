@@ -0,0 +1,101 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ANTTHREADPOOL_H
+#define ANTTHREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/*! \brief A minimal pool of worker threads for running data-parallel loops.
+ *
+ *  The range to be processed is split into fixed-size chunks which the calling thread and
+ *  the workers claim one at a time.  Since chunking does not depend on the number of threads,
+ *  the results of a loop whose iterations are independent do not depend on it either.
+ */
+
+class AntThreadPool
+{
+public:
+  /*! Constructs a pool running loops on "threadCount" threads (including the calling thread,
+   *  i.e. a pool of one thread runs everything on the calling thread). */
+  explicit AntThreadPool( int threadCount = 1 );
+
+  /*! Destructor (stops and joins the worker threads). */
+  ~AntThreadPool();
+
+  /*! Sets the number of threads (including the calling thread) used to run loops.  Values
+   *  smaller than 1 are treated as 1. */
+  void setThreadCount( int threadCount );
+
+  /*! Returns the number of threads (including the calling thread) used to run loops. */
+  int threadCount() const;
+
+  /*! Calls "task( begin, end )" for consecutive chunks of at most "chunkSize" indices covering
+   *  [ 0, "count" ) and returns once all chunks have been processed.  Chunks are processed
+   *  concurrently and in no particular order, "task" must therefore be safe to call from
+   *  multiple threads at once. */
+  void run( int count, int chunkSize, const std::function< void( int, int ) >& task );
+
+private:
+  /*! AntThreadPools are not copyable. */
+  AntThreadPool( const AntThreadPool& ) = delete;
+
+  /*! AntThreadPools are not assignable. */
+  AntThreadPool& operator=( const AntThreadPool& ) = delete;
+
+  /*! The worker threads' main loop ("generation" is that of the last loop run before the
+   *  worker was started). */
+  void work( unsigned int generation );
+
+  /*! Claims and processes chunks of the current loop until there are none left. */
+  void processChunks();
+
+  /*! Stops and joins all worker threads. */
+  void stop();
+
+private:
+  std::vector< std::thread > m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_started;
+  std::condition_variable m_finished;
+
+  const std::function< void( int, int ) >* m_task;
+  int m_count;
+  int m_chunkSize;
+  std::atomic< int > m_nextChunk;
+  int m_busyWorkers;
+  unsigned int m_generation;   // incremented for every loop, wakes the workers
+  bool m_stopping;
+};
+
+#endif // ANTTHREADPOOL_H
@@ -28,12 +28,17 @@
 
 #include "antworldscene.h"
 #include "graphicsworldtile.h"
-#include "world/graphicsantitem.h"
-#include "world/graphicspheromoneitem.h"
+#include "world/graphicssnapshotitem.h"
+#include "world/graphicsheatmapitem.h"
+#include "world/graphicsterrainitem.h"
+#include "ants/antsimulation.h"
+#include "ants/antworld.h"
 #include "utils/antconfig.h"
 
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsSceneDragDropEvent>
+#include <QGraphicsSceneHelpEvent>
+#include <QToolTip>
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -43,10 +48,25 @@ const qreal marginPerc = 0.02;   // percentage used for determining margins surr
 
 GraphicsAntWorldScene::GraphicsAntWorldScene( QObject* parent )
 : QGraphicsScene   ( parent ),
-  AntWorld         (),
+  m_terrainItem    ( nullptr ),
+  m_snapshotItem   ( nullptr ),
+  m_heatmapItem    ( nullptr ),
+  m_heatmapEnabled ( false ),
+  m_detailThreshold( AntConfig::DetailScale ),
+  m_tiles          (),
   m_type           ( AntWorldTile::None ),
   m_spawnPoints    (),
-  m_currentTileRect() {}
+  m_currentTileRect()
+{
+  createLayerItems();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+GraphicsAntWorldScene::~GraphicsAntWorldScene()
+{
+  deleteTiles();
+}
 
 /*--------------------------------------------------------------------------------------*/
 
@@ -66,7 +86,7 @@ void GraphicsAntWorldScene::constructWorldGrid()
     while( y < totalHeight )
     {
       m_currentTileRect = QRectF( x, y, AntConfig::TileSize, AntConfig::TileSize );
-      registerWorldTile( calculateCentreCoordinate( m_currentTileRect ), AntWorldTile::Wall );
+      addTile( AntWorldTile::Wall );
       y += AntConfig::TileSize;
     }
 
@@ -78,11 +98,12 @@ void GraphicsAntWorldScene::constructWorldGrid()
 
 void GraphicsAntWorldScene::reset()
 {
-  resetAntRegister();
-  resetPheromoneRegister();
-  resetWorldTileRegister();
+  deleteTiles();
   clear();
   m_spawnPoints.clear();
+
+  /* "clear" deleted the layer items along with everything else. */
+  createLayerItems();
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -96,46 +117,81 @@ void GraphicsAntWorldScene::addWorldTile( QDomElement element )
                                 qreal( element.attribute( "width" ).toDouble() ),
                                 qreal( element.attribute( "height" ).toDouble() ) );
 
-    registerWorldTile( calculateCentreCoordinate( m_currentTileRect ), static_cast< AntWorldTile::TileType >( element.attribute( "type" ).toInt() ) );
+    addTile( static_cast< AntWorldTile::TileType >( element.attribute( "type" ).toInt() ) );
   }
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-std::vector< const AntWorldTile* > GraphicsAntWorldScene::neighbours( const AntPosition& position ) const
+const QList< const GraphicsWorldTile *> &GraphicsAntWorldScene::spawnPoints() const
+{
+  return m_spawnPoints;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsAntWorldScene::setDetailThreshold( qreal scale )
+{
+  m_detailThreshold = scale;
+  m_terrainItem->setDetailThreshold( scale );
+  m_snapshotItem->setDetailThreshold( scale );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const std::vector< GraphicsWorldTile* >& GraphicsAntWorldScene::worldTiles() const
 {
-  QPointF pointF( qreal( position.x() ), qreal( position.y() ) );
+  return m_tiles;
+}
 
-  /* Since we're working in a 2D grid, we can get all 4 neighbour tiles by offsetting
-   * the relevant coordinate with the amount equal to the square edge of a tile (which
-   * should place us roughly near the centre of whichever neighbour we're searching for. */
-  QPointF northNeighbour( pointF + QPointF( 0.0, AntConfig::TileSize ) );
-  QPointF southNeighbour( pointF - QPointF( 0.0, AntConfig::TileSize ) );
-  QPointF westNeighbour( pointF + QPointF( AntConfig::TileSize, 0.0 ) );
-  QPointF eastNeighbour( pointF - QPointF( AntConfig::TileSize, 0.0 ) );
+/*--------------------------------------------------------------------------------------*/
 
-  QList< QPointF > neighboursPoints = QList< QPointF >() << northNeighbour << southNeighbour << westNeighbour << eastNeighbour;
-  std::vector< const AntWorldTile* > neighbours;
+void GraphicsAntWorldScene::copyWorldTiles( AntWorld& world ) const
+{
+  for( auto tile : m_tiles ) world.registerWorldTile( tile->centre(), tile->tileType() );
+}
+
+/*--------------------------------------------------------------------------------------*/
 
-  for( int i = 0; i < neighboursPoints.size(); ++i )
+bool GraphicsAntWorldScene::takeSnapshot( AntSimulation& simulation )
+{
+  if( simulation.takeSnapshot( m_snapshotItem->snapshot() ) )
   {
-    QList< QGraphicsItem* > itemList = items( neighboursPoints.at( i ) );
+    m_snapshotItem->setBounds( sceneRect() );
 
-    for( int j = 0; j < itemList.size(); ++j )
+    if( m_heatmapEnabled )
     {
-      GraphicsWorldTile* tile = dynamic_cast< GraphicsWorldTile* >( itemList.at( j ) );
-      if( tile ) neighbours.push_back( tile );
+      m_heatmapItem->setArea( m_terrainItem->tilesRect() );
+      m_heatmapItem->updateHeat( m_snapshotItem->snapshot() );
     }
+
+    return true;
   }
 
-  return neighbours;
+  return false;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-const QList< const GraphicsWorldTile *> &GraphicsAntWorldScene::spawnPoints() const
+const AntSnapshot& GraphicsAntWorldScene::snapshot() const
 {
-  return m_spawnPoints;
+  return m_snapshotItem->snapshot();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsAntWorldScene::setHeatmapEnabled( bool enabled )
+{
+  m_heatmapEnabled = enabled;
+  m_heatmapItem->setVisible( enabled );
+  m_snapshotItem->setPheromonesVisible( !enabled );
+
+  /* Catch up with the snapshot already shown rather than waiting for the next one. */
+  if( enabled )
+  {
+    m_heatmapItem->setArea( m_terrainItem->tilesRect() );
+    m_heatmapItem->updateHeat( m_snapshotItem->snapshot() );
+  }
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -161,40 +217,48 @@ void GraphicsAntWorldScene::mouseMoveEvent( QGraphicsSceneMouseEvent* event )
 
 /*--------------------------------------------------------------------------------------*/
 
-AntBot* GraphicsAntWorldScene::createAnt( const AntPosition& position )
+void GraphicsAntWorldScene::helpEvent( QGraphicsSceneHelpEvent* event )
 {
-  QPixmap pixMap( ":/resources/ant.png" );
-  GraphicsAntItem* ant = new GraphicsAntItem( this,
-                                              position,
-                                              pixMap.scaled( AntConfig::AntSize, AntConfig::AntSize, Qt::KeepAspectRatio ) );
+  const GraphicsWorldTile* tile = m_terrainItem->tileAt( event->scenePos() );
+  QString text = tile ? tile->toolTip() : QString();
 
-  addItem( ant );
-  return ant;
-}
-
-/*--------------------------------------------------------------------------------------*/
+  if( text.isEmpty() )
+  {
+    QToolTip::hideText();
+  }
+  else
+  {
+    QToolTip::showText( event->screenPos(), text, event->widget() );
+  }
 
-AntPheromone* GraphicsAntWorldScene::createPheromone( const AntPosition& position, AntPheromone::PheromoneType type )
-{
-  GraphicsPheromoneItem* pheromone = new GraphicsPheromoneItem( position, type );
-  addItem( pheromone );
-  return pheromone;
+  event->setAccepted( !text.isEmpty() );
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-AntWorldTile* GraphicsAntWorldScene::createWorldTile( const AntPosition& position, AntWorldTile::TileType type )
+void GraphicsAntWorldScene::addTile( AntWorldTile::TileType type )
 {
-  GraphicsWorldTile* tile = new GraphicsWorldTile( position, type );
-  tile->setRect( m_currentTileRect );
-  addItem( tile );    // takes ownership
+  /* Tiles shouldn't be duplicated (the terrain item only knows of one tile per grid cell). */
+  if( m_terrainItem->tileAt( m_currentTileRect.center() ) )
+  {
+    return;
+  }
+
+  GraphicsWorldTile* tile = new GraphicsWorldTile( calculateCentreCoordinate( m_currentTileRect ), type, m_currentTileRect, m_terrainItem );
+  m_tiles.push_back( tile );
 
   if( tile->tileType() == GraphicsWorldTile::Spawn )
   {
     m_spawnPoints.append( tile );
   }
+}
 
-  return tile;
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsAntWorldScene::deleteTiles()
+{
+  for( auto tile : m_tiles ) delete tile;
+  m_tiles.clear();
 }
 
 /*--------------------------------------------------------------------------------------*/
@@ -208,6 +272,23 @@ AntPosition GraphicsAntWorldScene::calculateCentreCoordinate( const QRectF& rect
 
 /*--------------------------------------------------------------------------------------*/
 
+void GraphicsAntWorldScene::createLayerItems()
+{
+  m_terrainItem = new GraphicsTerrainItem;
+  addItem( m_terrainItem );     // takes ownership
+
+  m_snapshotItem = new GraphicsSnapshotItem;
+  addItem( m_snapshotItem );    // takes ownership
+
+  m_heatmapItem = new GraphicsHeatmapItem;
+  addItem( m_heatmapItem );     // takes ownership
+
+  setHeatmapEnabled( m_heatmapEnabled );
+  setDetailThreshold( m_detailThreshold );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
 void GraphicsAntWorldScene::changeItemType( const QPointF& point )
 {
   if( m_type == GraphicsWorldTile::None )
@@ -215,26 +296,22 @@ void GraphicsAntWorldScene::changeItemType( const QPointF& point )
     return;
   }
 
-  QList< QGraphicsItem* > itemList = items( point );
+  GraphicsWorldTile* tile = m_terrainItem->tileAt( point );
 
-  for( int i = 0; i < itemList.size(); ++i )
+  if( tile )
   {
-    GraphicsWorldTile* tile = dynamic_cast< GraphicsWorldTile* >( itemList.at( i ) );
-
-    if( tile )
+    if( tile->tileType() == GraphicsWorldTile::Spawn )
     {
-      if( tile->tileType() == GraphicsWorldTile::Spawn )
-      {
-        m_spawnPoints.removeAll( tile );
-      }
-
-      if( m_type == GraphicsWorldTile::Spawn )
-      {
-        m_spawnPoints.append( tile );
-      }
+      m_spawnPoints.removeAll( tile );
+    }
 
-      tile->setTileType( m_type );
+    if( m_type == GraphicsWorldTile::Spawn )
+    {
+      m_spawnPoints.append( tile );
     }
+
+    tile->setTileType( m_type );
+    emit worldTileChanged( tile );
   }
 }
 
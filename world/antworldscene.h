@@ -29,22 +29,41 @@
 #ifndef GRAPHICSANTWORLDSCENE_H
 #define GRAPHICSANTWORLDSCENE_H
 
-#include "ants/antworld.h"
+#include "ants/antsnapshot.h"
 #include "graphicsworldtile.h"
 
 #include <QGraphicsScene>
 #include <QList>
 
-/*! \brief AntWorldScene is responsible for the world's graphical representation. */
+#include <vector>
 
-class GraphicsAntWorldScene : public QGraphicsScene,
-                              public AntWorld
+/*--------------------------------------------------------------------------------------*/
+
+class AntSimulation;
+class AntWorld;
+class GraphicsHeatmapItem;
+class GraphicsSnapshotItem;
+class GraphicsTerrainItem;
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief AntWorldScene is responsible for the world's graphical representation.
+ *
+ *  The scene is the world editor: it owns the world tiles and changes their types as the user
+ *  draws on them.  It doesn't run the sim itself, the tiles are copied into the AntWorld that
+ *  does (see copyWorldTiles) and the scene draws the snapshots published by it.
+ */
+
+class GraphicsAntWorldScene : public QGraphicsScene
 {
 Q_OBJECT
 public:
   /*! Constructor. */
   explicit GraphicsAntWorldScene( QObject* parent = 0 );
 
+  /*! Destructor. */
+  ~GraphicsAntWorldScene();
+
   /*! Builds a default world (all existing world items will be deleted). */
   void constructWorldGrid();
 
@@ -54,13 +73,39 @@ public:
   /*! Creates and adds a GraphicsWorldTile object from the given DOM element. */
   void addWorldTile( QDomElement element );
 
-  /*! Returns a list of all the world tiles immediately adjacent to that of the
-   *  tile with centre node position "position". */
-  std::vector< const AntWorldTile* > neighbours( const AntPosition& position ) const;
-
   /*! Returns a list of all the tiles that are user-defined spawn points. */
   const QList< const GraphicsWorldTile* >& spawnPoints() const;
 
+  /*! Returns all the tiles in the world (e.g. for saving it). */
+  const std::vector< GraphicsWorldTile* >& worldTiles() const;
+
+  /*! Registers a tile with "world" for every tile in the scene (in the same order and with
+   *  the same types), e.g. to run the world built in the editor on a HeadlessAntWorld. */
+  void copyWorldTiles( AntWorld& world ) const;
+
+  /*! Takes the latest snapshot published by "simulation" (if there is a new one) and draws
+   *  its ants and pheromones on top of the tiles.  Returns "true" if there was a new snapshot.
+   *
+   *  \sa snapshot */
+  bool takeSnapshot( AntSimulation& simulation );
+
+  /*! Returns the snapshot currently shown.
+   *
+   *  \sa takeSnapshot */
+  const AntSnapshot& snapshot() const;
+
+  /*! Sets whether the pheromones are shown as a heatmap over the tiles instead of being
+   *  drawn individually (disabled by default). */
+  void setHeatmapEnabled( bool enabled );
+
+  /*! Sets the view scale below which tiles, ants and pheromones are drawn as per pixel
+   *  summaries rather than individually (default AntConfig::DetailScale). */
+  void setDetailThreshold( qreal scale );
+
+signals:
+  /*! Emitted whenever the user changes the type of "tile". */
+  void worldTileChanged( GraphicsWorldTile* tile );
+
   public slots:
   /*! Sets the type when selecting graphics items via mouse input events.
    *  \sa mousePressEvent
@@ -77,15 +122,17 @@ protected:
    *  \sa changeItemType */
   void mouseMoveEvent( QGraphicsSceneMouseEvent* event );
 
-  /*! Re-implemented from AntWorld. */
-  AntBot* createAnt( const AntPosition& position );
+  /*! Re-implemented from QGraphicsScene to show the tooltip of the tile under the cursor
+   *  (tiles aren't items of their own, so the default implementation doesn't find them). */
+  void helpEvent( QGraphicsSceneHelpEvent* event );
 
-  /*! Re-implemented from AntWorld. */
-  AntPheromone* createPheromone( const AntPosition& position, AntPheromone::PheromoneType type );
-
-  /*! Re-implemented from AntWorld. */
-  AntWorldTile* createWorldTile( const AntPosition& position, AntWorldTile::TileType type );
 private:
+  /*! Adds a tile of "type" covering m_currentTileRect (unless there already is one). */
+  void addTile( AntWorldTile::TileType type );
+
+  /*! Deletes all the tiles. */
+  void deleteTiles();
+
   /*! Changes the item type under "point" to the current active type
    *  \sa setTileType */
   void changeItemType( const QPointF& point );
@@ -93,7 +140,16 @@ private:
   /*! Calculates the AntPosition at the centre of the "rect". */
   AntPosition calculateCentreCoordinate( const QRectF& rect );
 
+  /*! Creates the items that the tiles and snapshots are drawn with (after the scene was cleared). */
+  void createLayerItems();
+
 private:
+  GraphicsTerrainItem* m_terrainItem;     // owned by the scene
+  GraphicsSnapshotItem* m_snapshotItem;   // owned by the scene
+  GraphicsHeatmapItem* m_heatmapItem;     // owned by the scene
+  bool m_heatmapEnabled;
+  qreal m_detailThreshold;
+  std::vector< GraphicsWorldTile* > m_tiles;    // owned by the scene
   AntWorldTile::TileType m_type;
   QList< const GraphicsWorldTile* > m_spawnPoints;
   QRectF m_currentTileRect;
@@ -0,0 +1,166 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "graphicscache.h"
+
+#include <QHash>
+#include <QPainter>
+
+#include <algorithm>
+
+/*--------------------------------------------------------------------------------------*/
+
+QPixmap GraphicsCache::antPixmap( AntGraphics graphics )
+{
+  static QHash< int, QPixmap > pixmaps;
+
+  auto pixmap = pixmaps.find( graphics );
+
+  if( pixmap == pixmaps.end() )
+  {
+    const int size = static_cast< int >( AntConfig::AntSize );
+    QPixmap image( graphics == FoundAnt ? ":/resources/foundant.png" : ":/resources/ant.png" );
+    pixmap = pixmaps.insert( graphics, image.scaled( size, size, Qt::KeepAspectRatio ) );
+  }
+
+  return pixmap.value();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const QBrush& GraphicsCache::pheromoneBrush( AntPheromone::PheromoneType type )
+{
+  static const QBrush found( Qt::darkGreen );
+  static const QBrush hazard( Qt::darkRed );
+  static const QBrush none( Qt::white );
+
+  switch( type )
+  {
+    case AntPheromone::Found:
+      return found;
+    case AntPheromone::Hazard:
+      return hazard;
+    case AntPheromone::None:
+    default:
+      return none;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const QPen& GraphicsCache::pheromonePen()
+{
+  static const QPen pen( Qt::darkGray );
+  return pen;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QPixmap GraphicsCache::pheromonePixmap( AntPheromone::PheromoneType type )
+{
+  static QHash< int, QPixmap > pixmaps;
+
+  auto pixmap = pixmaps.find( type );
+
+  if( pixmap == pixmaps.end() )
+  {
+    /* Leave room for the outline (which is centred on the circle's edge). */
+    const int size = static_cast< int >( AntConfig::PheromoneSize ) + 2;
+    QPixmap sprite( size, size );
+    sprite.fill( Qt::transparent );
+
+    QPainter painter( &sprite );
+    painter.setRenderHint( QPainter::Antialiasing );
+    painter.setPen( pheromonePen() );
+    painter.setBrush( pheromoneBrush( type ) );
+    painter.drawEllipse( QPointF( size / 2.0, size / 2.0 ), AntConfig::PheromoneSize / 2, AntConfig::PheromoneSize / 2 );
+    painter.end();
+
+    pixmap = pixmaps.insert( type, sprite );
+  }
+
+  return pixmap.value();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const QBrush& GraphicsCache::tileBrush( AntWorldTile::TileType type )
+{
+  static const QBrush path( Qt::white );
+  static const QBrush wall( Qt::darkBlue );
+  static const QBrush hazard( Qt::darkRed );
+  static const QBrush food( Qt::darkGreen );
+  static const QBrush spawn( Qt::darkMagenta );
+  static const QBrush none( Qt::NoBrush );
+
+  switch( type )
+  {
+    case AntWorldTile::Path:
+      return path;
+    case AntWorldTile::Hazard:
+      return hazard;
+    case AntWorldTile::Food:
+      return food;
+    case AntWorldTile::Spawn:
+      return spawn;
+    case AntWorldTile::None:
+      return none;
+    case AntWorldTile::Wall:
+    default:
+      return wall;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const QPen& GraphicsCache::tilePen()
+{
+  static const QPen pen( Qt::black );
+  return pen;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QRgb GraphicsCache::pheromoneHeat( double found, double hazard )
+{
+  const int maxAlpha = 192;   // never completely hide what is underneath
+  const double total = found + hazard;
+  const int alpha = static_cast< int >( std::min( std::max( found, hazard ), 1.0 ) * maxAlpha );
+
+  if( total <= 0.0 || alpha <= 0 )
+  {
+    return 0;
+  }
+
+  return qPremultiply( qRgba( static_cast< int >( 255 * hazard / total ),
+                              static_cast< int >( 255 * found / total ),
+                              0,
+                              alpha ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
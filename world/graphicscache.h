@@ -0,0 +1,91 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef GRAPHICSCACHE_H
+#define GRAPHICSCACHE_H
+
+#include "ants/antpheromone.h"
+#include "ants/antworldtile.h"
+#include "utils/antconfig.h"
+
+#include <QPixmap>
+#include <QBrush>
+#include <QPen>
+
+/*! \brief A process-wide cache of the pixmaps, brushes and pens shared by the graphics items.
+ *
+ *  The layer items (GraphicsSnapshotItem, GraphicsTerrainItem and GraphicsHeatmapItem) draw
+ *  every ant, pheromone and tile from the same implicitly shared QPixmap/QBrush, so that
+ *  drawing them doesn't involve loading, decoding or scaling any images.  The pixmaps are
+ *  loaded, scaled or drawn the first time they are asked for.
+ *
+ *  \warning pixmaps may only be used from the GUI thread, and so may this class.
+ */
+
+class GraphicsCache
+{
+public:
+  /*! The ant graphics. */
+  enum AntGraphics
+  {
+    ForagingAnt,
+    FoundAnt
+  };
+
+  /*! Returns the pixmap for "graphics" scaled to fit an AntConfig::AntSize square (a shallow
+   *  copy of the cached pixmap, i.e. no pixel data is copied). */
+  static QPixmap antPixmap( AntGraphics graphics );
+
+  /*! Returns the brush with which pheromones of "type" are filled. */
+  static const QBrush& pheromoneBrush( AntPheromone::PheromoneType type );
+
+  /*! Returns the pen with which pheromones are outlined. */
+  static const QPen& pheromonePen();
+
+  /*! Returns a pixmap of a pheromone of "type" (an AntConfig::PheromoneSize circle drawn with
+   *  pheromoneBrush and pheromonePen), for drawing many pheromones as copies of one sprite. */
+  static QPixmap pheromonePixmap( AntPheromone::PheromoneType type );
+
+  /*! Returns the brush with which tiles of "type" are filled (Qt::NoBrush for "None", which
+   *  doesn't change a tile's look). */
+  static const QBrush& tileBrush( AntWorldTile::TileType type );
+
+  /*! Returns the pen with which tiles are outlined. */
+  static const QPen& tilePen();
+
+  /*! Returns the (premultiplied) colour of a pixel summarising pheromones of "found" and
+   *  "hazard" total strength: green for trails leading to food, red near hazards, more
+   *  opaque the stronger they are (but never quite opaque).  Returns 0 if there are none. */
+  static QRgb pheromoneHeat( double found, double hazard );
+
+private:
+  /*! GraphicsCache only has static members. */
+  GraphicsCache() = delete;
+};
+
+#endif // GRAPHICSCACHE_H
@@ -0,0 +1,188 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "graphicsheatmapitem.h"
+#include "graphicscache.h"
+#include "utils/antconfig.h"
+
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+/*--------------------------------------------------------------------------------------*/
+
+GraphicsHeatmapItem::GraphicsHeatmapItem( QGraphicsItem* parent )
+: QGraphicsItem( parent ),
+  m_area       (),
+  m_image      (),
+  m_heat       (),
+  m_stamp      (),
+  m_lit        (),
+  m_nextLit    (),
+  m_update     ( 0 )
+{
+  setZValue( 0.5 );           // above the tiles, under the ants
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsHeatmapItem::setArea( const QRectF& area )
+{
+  if( area == m_area )
+  {
+    return;
+  }
+
+  prepareGeometryChange();
+  m_area = area;
+
+  const int columns = qRound( area.width() / AntConfig::TileSize );
+  const int rows = qRound( area.height() / AntConfig::TileSize );
+  const size_t pixels = static_cast< size_t >( std::max( columns, 0 ) ) * static_cast< size_t >( std::max( rows, 0 ) );
+
+  m_image = QImage( columns, rows, QImage::Format_ARGB32_Premultiplied );
+  m_image.fill( Qt::transparent );
+
+  m_heat.assign( pixels, Heat() );
+  m_stamp.assign( pixels, 0 );
+  m_lit.clear();
+  m_update = 0;
+
+  update();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsHeatmapItem::updateHeat( const AntSnapshot& snapshot )
+{
+  if( m_image.isNull() )
+  {
+    return;
+  }
+
+  if( ++m_update == 0 )
+  {
+    std::fill( m_stamp.begin(), m_stamp.end(), 0 );
+    m_update = 1;
+  }
+
+  /* Sum up the strengths per tile, remembering which tiles have any. */
+  const int columns = m_image.width();
+  const int rows = m_image.height();
+  m_nextLit.clear();
+
+  for( const auto& pheromone : snapshot.pheromones )
+  {
+    const int column = static_cast< int >( std::floor( ( pheromone.position.x() - m_area.left() ) / AntConfig::TileSize ) );
+    const int row = static_cast< int >( std::floor( ( pheromone.position.y() - m_area.top() ) / AntConfig::TileSize ) );
+
+    if( column < 0 || column >= columns || row < 0 || row >= rows )
+    {
+      continue;
+    }
+
+    const int index = row * columns + column;
+    Heat& heat = m_heat[ index ];
+
+    if( m_stamp[ index ] != m_update )
+    {
+      m_stamp[ index ] = m_update;
+      heat = Heat();
+      m_nextLit.push_back( index );
+    }
+
+    if( pheromone.type == AntPheromone::Found )
+    {
+      heat.found += pheromone.strength;
+    }
+    else if( pheromone.type == AntPheromone::Hazard )
+    {
+      heat.hazard += pheromone.strength;
+    }
+  }
+
+  /* Clear the tiles that have gone cold, then (re)colour the rest. */
+  bool changed( false );
+
+  for( int index : m_lit )
+  {
+    if( m_stamp[ index ] != m_update )
+    {
+      changed |= setPixel( index, 0 );
+    }
+  }
+
+  for( int index : m_nextLit )
+  {
+    changed |= setPixel( index, GraphicsCache::pheromoneHeat( m_heat[ index ].found, m_heat[ index ].hazard ) );
+  }
+
+  m_lit.swap( m_nextLit );
+
+  if( changed )
+  {
+    update();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QRectF GraphicsHeatmapItem::boundingRect() const
+{
+  return m_area;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsHeatmapItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* /*option*/, QWidget* /*widget*/ )
+{
+  if( !m_image.isNull() )
+  {
+    /* Smoothing blurs the tiles into each other, which suits a heatmap. */
+    painter->setRenderHint( QPainter::SmoothPixmapTransform );
+    painter->drawImage( m_area, m_image );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+bool GraphicsHeatmapItem::setPixel( int index, QRgb rgb )
+{
+  QRgb* pixels = reinterpret_cast< QRgb* >( m_image.bits() );
+
+  if( pixels[ index ] == rgb )
+  {
+    return false;
+  }
+
+  pixels[ index ] = rgb;
+  return true;
+}
+
+/*--------------------------------------------------------------------------------------*/
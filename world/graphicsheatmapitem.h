@@ -0,0 +1,88 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef GRAPHICSHEATMAPITEM_H
+#define GRAPHICSHEATMAPITEM_H
+
+#include "ants/antsnapshot.h"
+
+#include <QGraphicsItem>
+#include <QImage>
+
+#include <vector>
+
+/*! \brief Draws the pheromones in an AntSnapshot as a heatmap with one pixel per world tile
+ *  (green where the trail leads to food, red near hazards), scaled up over the world grid.
+ *
+ *  Only the pixels of tiles whose pheromones changed visibly since the previous snapshot are
+ *  written and the image is drawn as it is (it isn't converted to a pixmap), so the cost of a
+ *  frame doesn't grow with the size of the world or the number of pheromones that are merely
+ *  still there.
+ */
+
+class GraphicsHeatmapItem : public QGraphicsItem
+{
+public:
+  /*! Constructor. */
+  explicit GraphicsHeatmapItem( QGraphicsItem* parent = 0 );
+
+  /*! Sets the area covered by the world grid (which must be aligned to tile edges).  If the
+   *  area changes, the heatmap is cleared. */
+  void setArea( const QRectF& area );
+
+  /*! Updates the heatmap to show the pheromones in "snapshot". */
+  void updateHeat( const AntSnapshot& snapshot );
+
+  /*! Re-implemented from QGraphicsItem. */
+  QRectF boundingRect() const;
+
+  /*! Re-implemented from QGraphicsItem. */
+  void paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget );
+
+private:
+  /*! The pheromone strengths summed per tile. */
+  struct Heat
+  {
+    double found;
+    double hazard;
+  };
+
+  /*! Sets pixel "index" to "rgb", returning "true" if that changed it. */
+  bool setPixel( int index, QRgb rgb );
+
+private:
+  QRectF m_area;
+  QImage m_image;                     // one pixel per tile
+  std::vector< Heat > m_heat;         // per pixel, only valid for the pixels in m_lit
+  std::vector< unsigned > m_stamp;    // per pixel, the update that last lit it
+  std::vector< int > m_lit;           // the pixels lit by the last update
+  std::vector< int > m_nextLit;
+  unsigned m_update;
+};
+
+#endif // GRAPHICSHEATMAPITEM_H
@@ -0,0 +1,275 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "graphicssnapshotitem.h"
+#include "graphicscache.h"
+#include "utils/antconfig.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+#include <cmath>
+
+/*--------------------------------------------------------------------------------------*/
+
+GraphicsSnapshotItem::GraphicsSnapshotItem( QGraphicsItem* parent )
+: QGraphicsItem      ( parent ),
+  m_snapshot         (),
+  m_bounds           (),
+  m_pheromonesVisible( true ),
+  m_detailThreshold  ( AntConfig::DetailScale ),
+  m_summary          (),
+  m_summaryArea      (),
+  m_summaryScale     ( 0.0 ),
+  m_foundSums        (),
+  m_hazardSums       (),
+  m_antCounts        ()
+{
+  setZValue( 1.0 );           // always draw on top
+  setFlag( QGraphicsItem::ItemUsesExtendedStyleOption );    // for the exposed rect
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+AntSnapshot& GraphicsSnapshotItem::snapshot()
+{
+  return m_snapshot;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::setBounds( const QRectF& bounds )
+{
+  if( bounds != m_bounds )
+  {
+    prepareGeometryChange();
+    m_bounds = bounds;
+  }
+
+  m_summaryScale = 0.0;
+  update();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::setPheromonesVisible( bool visible )
+{
+  m_pheromonesVisible = visible;
+  m_summaryScale = 0.0;
+  update();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::setDetailThreshold( qreal scale )
+{
+  m_detailThreshold = scale;
+  update();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QRectF GraphicsSnapshotItem::boundingRect() const
+{
+  return m_bounds;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* /*widget*/ )
+{
+  const qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform( painter->worldTransform() );
+
+  if( scale < m_detailThreshold )
+  {
+    drawSummary( painter, option->exposedRect, scale );
+    return;
+  }
+
+  /* Pheromones fade as they evaporate (all pheromone sprites are the same size). */
+  const QRectF pheromoneSprite = GraphicsCache::pheromonePixmap( AntPheromone::None ).rect();
+
+  for( auto& fragments : m_pheromoneFragments )
+  {
+    fragments.clear();
+  }
+
+  if( m_pheromonesVisible )
+  {
+    for( const auto& pheromone : m_snapshot.pheromones )
+    {
+      addFragment( m_pheromoneFragments[ pheromone.type ],
+                   QPointF( pheromone.position.x(), pheromone.position.y() ),
+                   pheromoneSprite, qBound( 0.0, qreal( pheromone.strength ), 1.0 ) );
+    }
+  }
+
+  for( int type = 0; type <= AntPheromone::None; ++type )
+  {
+    drawFragments( painter, m_pheromoneFragments[ type ],
+                   GraphicsCache::pheromonePixmap( static_cast< AntPheromone::PheromoneType >( type ) ) );
+  }
+
+  /* Ants are drawn centred on their positions. */
+  const QPixmap foraging = GraphicsCache::antPixmap( GraphicsCache::ForagingAnt );
+  const QPixmap returning = GraphicsCache::antPixmap( GraphicsCache::FoundAnt );
+
+  m_foragingFragments.clear();
+  m_returningFragments.clear();
+
+  const QRectF foragingSprite = foraging.rect();
+  const QRectF returningSprite = returning.rect();
+
+  for( const auto& ant : m_snapshot.ants )
+  {
+    const QPointF centre( ant.position.x(), ant.position.y() );
+
+    if( ant.returning )
+    {
+      addFragment( m_returningFragments, centre, returningSprite );
+    }
+    else
+    {
+      addFragment( m_foragingFragments, centre, foragingSprite );
+    }
+  }
+
+  drawFragments( painter, m_foragingFragments, foraging );
+  drawFragments( painter, m_returningFragments, returning );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::addFragment( std::vector< QPainter::PixmapFragment >& fragments,
+                                        const QPointF& centre, const QRectF& sprite, qreal opacity )
+{
+  fragments.push_back( QPainter::PixmapFragment::create( centre, sprite, 1.0, 1.0, 0.0, opacity ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::drawFragments( QPainter* painter, const std::vector< QPainter::PixmapFragment >& fragments,
+                                          const QPixmap& pixmap )
+{
+  if( !fragments.empty() )
+  {
+    painter->drawPixmapFragments( fragments.data(), static_cast< int >( fragments.size() ), pixmap );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsSnapshotItem::drawSummary( QPainter* painter, const QRectF& exposed, qreal scale )
+{
+  /* One summary pixel covers one screen pixel, on a grid anchored at the item's top left so
+   * that pixels don't shift as the view scrolls. */
+  const qreal cell = 1.0 / scale;
+  const QRectF visible = exposed & m_bounds;
+
+  if( visible.isEmpty() )
+  {
+    return;
+  }
+
+  const int firstColumn = static_cast< int >( std::floor( ( visible.left() - m_bounds.left() ) / cell ) );
+  const int firstRow = static_cast< int >( std::floor( ( visible.top() - m_bounds.top() ) / cell ) );
+  const int columns = static_cast< int >( std::ceil( ( visible.right() - m_bounds.left() ) / cell ) ) - firstColumn;
+  const int rows = static_cast< int >( std::ceil( ( visible.bottom() - m_bounds.top() ) / cell ) ) - firstRow;
+
+  const QRectF area( m_bounds.left() + firstColumn * cell, m_bounds.top() + firstRow * cell, columns * cell, rows * cell );
+
+  if( scale != m_summaryScale || area != m_summaryArea )
+  {
+    m_summaryScale = scale;
+    m_summaryArea = area;
+
+    if( m_summary.width() < columns || m_summary.height() < rows )
+    {
+      m_summary = QImage( std::max( columns, m_summary.width() ), std::max( rows, m_summary.height() ),
+                          QImage::Format_ARGB32_Premultiplied );
+    }
+
+    const size_t pixels = static_cast< size_t >( columns ) * static_cast< size_t >( rows );
+
+    if( m_antCounts.size() < pixels )
+    {
+      m_foundSums.resize( pixels );
+      m_hazardSums.resize( pixels );
+      m_antCounts.resize( pixels );
+    }
+
+    std::fill_n( m_foundSums.begin(), pixels, 0.0 );
+    std::fill_n( m_hazardSums.begin(), pixels, 0.0 );
+    std::fill_n( m_antCounts.begin(), pixels, 0 );
+
+    /* Returns the index of the summary pixel covering "position" (or -1 if none does). */
+    auto pixelIndex = [ & ]( const AntPosition& position ) -> int
+    {
+      const int column = static_cast< int >( std::floor( ( position.x() - area.left() ) / cell ) );
+      const int row = static_cast< int >( std::floor( ( position.y() - area.top() ) / cell ) );
+      return ( column >= 0 && column < columns && row >= 0 && row < rows ) ? row * columns + column : -1;
+    };
+
+    if( m_pheromonesVisible )
+    {
+      for( const auto& pheromone : m_snapshot.pheromones )
+      {
+        const int index = pixelIndex( pheromone.position );
+
+        if( index != -1 )
+        {
+          if( pheromone.type == AntPheromone::Found ) m_foundSums[ index ] += pheromone.strength;
+          if( pheromone.type == AntPheromone::Hazard ) m_hazardSums[ index ] += pheromone.strength;
+        }
+      }
+    }
+
+    for( const auto& ant : m_snapshot.ants )
+    {
+      const int index = pixelIndex( ant.position );
+      if( index != -1 ) ++m_antCounts[ index ];
+    }
+
+    for( int row = 0; row < rows; ++row )
+    {
+      QRgb* line = reinterpret_cast< QRgb* >( m_summary.scanLine( row ) );
+
+      for( int column = 0; column < columns; ++column )
+      {
+        const int i = row * columns + column;
+        line[ column ] = ( m_antCounts[ i ] > 0 ) ? qRgba( 0, 0, 0, std::min( 128 + 32 * m_antCounts[ i ], 255 ) )
+                                                  : GraphicsCache::pheromoneHeat( m_foundSums[ i ], m_hazardSums[ i ] );
+      }
+    }
+  }
+
+  painter->drawImage( area, m_summary, QRectF( 0.0, 0.0, columns, rows ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
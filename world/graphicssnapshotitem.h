@@ -0,0 +1,113 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef GRAPHICSSNAPSHOTITEM_H
+#define GRAPHICSSNAPSHOTITEM_H
+
+#include "ants/antsnapshot.h"
+#include "ants/antpheromone.h"
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPainter>
+
+#include <vector>
+
+/*! \brief A single scene item drawing all the ants and pheromones in an AntSnapshot (the
+ *  world itself runs elsewhere, see AntSimulation).
+ *
+ *  Everything showing the same sprite (see GraphicsCache) is drawn with a single
+ *  QPainter::drawPixmapFragments call rather than one draw call (or QGraphicsItem) each.
+ *
+ *  Below the detail threshold scale, sprites would be too small to make out and the item
+ *  draws a summary instead: an image of the exposed area with one pixel per screen pixel
+ *  showing where there are ants (darker the more there are) and how strong the pheromones
+ *  there are, so that the cost of a frame is bounded by the size of the view rather than
+ *  that of the world. */
+
+class GraphicsSnapshotItem : public QGraphicsItem
+{
+public:
+  /*! Constructor. */
+  explicit GraphicsSnapshotItem( QGraphicsItem* parent = 0 );
+
+  /*! Returns the snapshot being drawn (take new snapshots into it, then call setBounds or
+   *  update to have them drawn). */
+  AntSnapshot& snapshot();
+
+  /*! Sets the area of the scene that the ants and pheromones are drawn in. */
+  void setBounds( const QRectF& bounds );
+
+  /*! Sets whether or not the pheromones are drawn (e.g. when a GraphicsHeatmapItem shows
+   *  them instead). */
+  void setPheromonesVisible( bool visible );
+
+  /*! Sets the view scale below which the summary is drawn instead of the sprites (default
+   *  AntConfig::DetailScale). */
+  void setDetailThreshold( qreal scale );
+
+  /*! Re-implemented from QGraphicsItem. */
+  QRectF boundingRect() const;
+
+  /*! Re-implemented from QGraphicsItem. */
+  void paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget );
+
+private:
+  /*! Appends a fragment drawing the whole of "sprite" centred on "centre". */
+  static void addFragment( std::vector< QPainter::PixmapFragment >& fragments,
+                           const QPointF& centre, const QRectF& sprite, qreal opacity = 1.0 );
+
+  /*! Draws "fragments" of "pixmap" (if any). */
+  static void drawFragments( QPainter* painter, const std::vector< QPainter::PixmapFragment >& fragments,
+                             const QPixmap& pixmap );
+
+  /*! Draws the summary of the "exposed" part of the snapshot at "scale" with "painter"
+   *  (rebuilding it first if the snapshot, area or scale changed since it was last built). */
+  void drawSummary( QPainter* painter, const QRectF& exposed, qreal scale );
+
+private:
+  AntSnapshot m_snapshot;
+  QRectF m_bounds;
+  bool m_pheromonesVisible;
+  qreal m_detailThreshold;
+
+  /* The summary buffers only ever grow, so that they are reused from frame to frame. */
+  QImage m_summary;
+  QRectF m_summaryArea;                                 // the area summarised (as drawn)
+  qreal m_summaryScale;                                 // 0.0 if m_summary is out of date
+  std::vector< double > m_foundSums;                    // per summary pixel
+  std::vector< double > m_hazardSums;
+  std::vector< int > m_antCounts;
+
+  /* Kept between paints so that their storage is reused. */
+  std::vector< QPainter::PixmapFragment > m_pheromoneFragments[ AntPheromone::None + 1 ];
+  std::vector< QPainter::PixmapFragment > m_foragingFragments;
+  std::vector< QPainter::PixmapFragment > m_returningFragments;
+};
+
+#endif // GRAPHICSSNAPSHOTITEM_H
@@ -0,0 +1,412 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#include "graphicsterrainitem.h"
+#include "graphicsworldtile.h"
+#include "graphicscache.h"
+#include "utils/antconfig.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+#include <cmath>
+
+/*--------------------------------------------------------------------------------------*/
+
+const qreal chunkMargin = 1.0;   // room around a chunk's pixmap for the outlines of its edge tiles
+
+/*--------------------------------------------------------------------------------------*/
+
+/* Rounds towards negative infinity (the grid extends left of and above the first tile if
+ * tiles are added there). */
+static int floorDivide( int numerator, int denominator )
+{
+  return ( numerator >= 0 ) ? numerator / denominator : -( ( -numerator + denominator - 1 ) / denominator );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+GraphicsTerrainItem::GraphicsTerrainItem( QGraphicsItem* parent )
+: QGraphicsItem    ( parent ),
+  m_chunks         (),
+  m_cachedChunks   ( 0 ),
+  m_paints         ( 0 ),
+  m_origin         (),
+  m_tilesRect      (),
+  m_bounds         (),
+  m_detailThreshold( AntConfig::DetailScale ),
+  m_overview       (),
+  m_overviewStale  ( true )
+{
+  setFlag( QGraphicsItem::ItemUsesExtendedStyleOption );    // for the exposed rect
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::updateTile( GraphicsWorldTile* tile )
+{
+  /* The first tile added anchors the grid at ( 0, 0 ). */
+  if( m_tilesRect.isNull() )
+  {
+    m_origin = tile->rect().topLeft();
+  }
+
+  if( !m_tilesRect.contains( tile->rect() ) )
+  {
+    prepareGeometryChange();
+    m_tilesRect |= tile->rect();
+    m_bounds = m_tilesRect.adjusted( -chunkMargin, -chunkMargin, chunkMargin, chunkMargin );
+    m_overviewStale = true;
+  }
+
+  int row( 0 );
+  int column( 0 );
+  gridCoordinates( tile->rect().center(), row, column );
+
+  QPair< int, int > key = chunkKey( row, column );
+  auto chunk = m_chunks.find( key );
+
+  if( chunk == m_chunks.end() )
+  {
+    const qreal side = ChunkTiles * AntConfig::TileSize;
+
+    Chunk newChunk;
+    newChunk.rect = QRectF( m_origin.x() + key.second * side, m_origin.y() + key.first * side, side, side );
+    newChunk.tiles.assign( ChunkTiles * ChunkTiles, nullptr );
+    newChunk.dirty = true;
+    newChunk.lastDrawn = 0;
+    chunk = m_chunks.insert( key, newChunk );
+  }
+
+  chunk->tiles[ chunkIndex( row, column ) ] = tile;
+
+  /* Chunks that haven't been drawn yet will draw the tile along with the rest. */
+  if( !chunk->dirty )
+  {
+    QPainter painter( &chunk->pixmap );
+    painter.translate( chunkMargin - chunk->rect.left(), chunkMargin - chunk->rect.top() );
+    drawTile( painter, *tile );
+  }
+
+  if( !m_overviewStale )
+  {
+    drawOverviewTile( *tile );
+  }
+
+  update( tile->rect().adjusted( -chunkMargin, -chunkMargin, chunkMargin, chunkMargin ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+GraphicsWorldTile* GraphicsTerrainItem::tileAt( const QPointF& point ) const
+{
+  if( !m_tilesRect.contains( point ) )
+  {
+    return nullptr;
+  }
+
+  int row( 0 );
+  int column( 0 );
+  gridCoordinates( point, row, column );
+
+  auto chunk = m_chunks.find( chunkKey( row, column ) );
+  return ( chunk != m_chunks.end() ) ? chunk->tiles[ chunkIndex( row, column ) ] : nullptr;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+const QRectF& GraphicsTerrainItem::tilesRect() const
+{
+  return m_tilesRect;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::setDetailThreshold( qreal scale )
+{
+  m_detailThreshold = scale;
+  update();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QRectF GraphicsTerrainItem::boundingRect() const
+{
+  return m_bounds;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* /*widget*/ )
+{
+  const qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform( painter->worldTransform() );
+
+  if( scale < m_detailThreshold )
+  {
+    drawOverview( painter, option->exposedRect, scale );
+    return;
+  }
+
+  ++m_paints;
+
+  for( auto chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk )
+  {
+    if( chunk->rect.intersects( option->exposedRect ) )
+    {
+      if( chunk->dirty )
+      {
+        m_cachedChunks += chunk->pixmap.isNull() ? 1 : 0;
+        drawChunk( *chunk );
+      }
+
+      chunk->lastDrawn = m_paints;
+      painter->drawPixmap( chunk->rect.topLeft() - QPointF( chunkMargin, chunkMargin ), chunk->pixmap );
+    }
+  }
+
+  if( m_cachedChunks > MaxCachedChunks )
+  {
+    freeChunks();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::gridCoordinates( const QPointF& point, int& row, int& column ) const
+{
+  row = static_cast< int >( std::floor( ( point.y() - m_origin.y() ) / AntConfig::TileSize ) );
+  column = static_cast< int >( std::floor( ( point.x() - m_origin.x() ) / AntConfig::TileSize ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QPair< int, int > GraphicsTerrainItem::chunkKey( int row, int column )
+{
+  return QPair< int, int >( floorDivide( row, ChunkTiles ), floorDivide( column, ChunkTiles ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+int GraphicsTerrainItem::chunkIndex( int row, int column )
+{
+  return ( row - floorDivide( row, ChunkTiles ) * ChunkTiles ) * ChunkTiles
+         + ( column - floorDivide( column, ChunkTiles ) * ChunkTiles );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::drawChunk( Chunk& chunk )
+{
+  const int side = static_cast< int >( std::ceil( chunk.rect.width() + 2 * chunkMargin ) );
+  chunk.pixmap = QPixmap( side, side );
+  chunk.pixmap.fill( Qt::transparent );
+
+  QPainter painter( &chunk.pixmap );
+  painter.translate( chunkMargin - chunk.rect.left(), chunkMargin - chunk.rect.top() );
+
+  for( const GraphicsWorldTile* tile : chunk.tiles )
+  {
+    if( tile )
+    {
+      drawTile( painter, *tile );
+    }
+  }
+
+  chunk.dirty = false;
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::freeChunks()
+{
+  std::vector< Chunk* > cached;
+
+  for( auto chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk )
+  {
+    if( !chunk->pixmap.isNull() && chunk->lastDrawn != m_paints )
+    {
+      cached.push_back( &chunk.value() );
+    }
+  }
+
+  std::sort( cached.begin(), cached.end(), []( const Chunk* a, const Chunk* b ){ return a->lastDrawn < b->lastDrawn; } );
+
+  for( auto chunk = cached.begin(); chunk != cached.end() && m_cachedChunks > MaxCachedChunks; ++chunk )
+  {
+    ( *chunk )->pixmap = QPixmap();
+    ( *chunk )->dirty = true;
+    --m_cachedChunks;
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::drawTile( QPainter& painter, const GraphicsWorldTile& tile )
+{
+  if( tile.tileType() == GraphicsWorldTile::None )
+  {
+    return;
+  }
+
+  painter.setPen( GraphicsCache::tilePen() );
+  painter.setBrush( GraphicsCache::tileBrush( tile.tileType() ) );
+  painter.drawRect( tile.rect() );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::drawOverviewTile( const GraphicsWorldTile& tile )
+{
+  int row( 0 );
+  int column( 0 );
+  gridCoordinates( tile.rect().center(), row, column );
+
+  int firstRow( 0 );
+  int firstColumn( 0 );
+  gridCoordinates( m_tilesRect.topLeft() + QPointF( AntConfig::TileSize / 2, AntConfig::TileSize / 2 ), firstRow, firstColumn );
+
+  if( tile.tileType() == GraphicsWorldTile::None )
+  {
+    return;
+  }
+
+  int x = column - firstColumn;
+  int y = row - firstRow;
+  m_overview.front().setPixel( x, y, GraphicsCache::tileBrush( tile.tileType() ).color().rgba() );
+
+  for( int level = 1; level < static_cast< int >( m_overview.size() ); ++level )
+  {
+    x /= 2;
+    y /= 2;
+    downsampleOverview( level, x, y );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::buildOverview()
+{
+  QImage tiles( qRound( m_tilesRect.width() / AntConfig::TileSize ),
+                qRound( m_tilesRect.height() / AntConfig::TileSize ),
+                QImage::Format_ARGB32_Premultiplied );
+  tiles.fill( Qt::transparent );
+
+  m_overview.clear();
+  m_overview.push_back( tiles );
+  m_overviewStale = false;
+
+  for( auto chunk = m_chunks.constBegin(); chunk != m_chunks.constEnd(); ++chunk )
+  {
+    for( const GraphicsWorldTile* tile : chunk->tiles )
+    {
+      if( tile )
+      {
+        drawOverviewTile( *tile );    // only level 0 so far, the others are built below
+      }
+    }
+  }
+
+  while( m_overview.back().width() > 1 || m_overview.back().height() > 1 )
+  {
+    const QImage& below = m_overview.back();
+    m_overview.push_back( QImage( ( below.width() + 1 ) / 2, ( below.height() + 1 ) / 2, QImage::Format_ARGB32_Premultiplied ) );
+
+    const int level = static_cast< int >( m_overview.size() ) - 1;
+
+    for( int y = 0; y < m_overview.back().height(); ++y )
+    {
+      for( int x = 0; x < m_overview.back().width(); ++x )
+      {
+        downsampleOverview( level, x, y );
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::downsampleOverview( int level, int x, int y )
+{
+  const QImage& below = m_overview[ level - 1 ];
+  int red( 0 );
+  int green( 0 );
+  int blue( 0 );
+  int alpha( 0 );
+  int pixels( 0 );
+
+  for( int belowY = 2 * y; belowY < std::min( 2 * y + 2, below.height() ); ++belowY )
+  {
+    const QRgb* line = reinterpret_cast< const QRgb* >( below.constScanLine( belowY ) );
+
+    for( int belowX = 2 * x; belowX < std::min( 2 * x + 2, below.width() ); ++belowX )
+    {
+      /* Averaging premultiplied pixels weighs colours by their opacity (gaps count as clear). */
+      red += qRed( line[ belowX ] );
+      green += qGreen( line[ belowX ] );
+      blue += qBlue( line[ belowX ] );
+      alpha += qAlpha( line[ belowX ] );
+      ++pixels;
+    }
+  }
+
+  m_overview[ level ].setPixel( x, y, qRgba( red / pixels, green / pixels, blue / pixels, alpha / pixels ) );
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsTerrainItem::drawOverview( QPainter* painter, const QRectF& exposed, qreal scale )
+{
+  if( m_overviewStale )
+  {
+    buildOverview();
+  }
+
+  /* Pick the most detailed level whose pixels aren't smaller than a screen pixel. */
+  int level( 0 );
+  qreal pixelSize( AntConfig::TileSize );
+
+  while( level + 1 < static_cast< int >( m_overview.size() ) && pixelSize * scale < 1.0 )
+  {
+    ++level;
+    pixelSize *= 2;
+  }
+
+  const QRectF area = exposed & m_tilesRect;
+
+  if( !area.isEmpty() )
+  {
+    const QRectF source( ( area.left() - m_tilesRect.left() ) / pixelSize,
+                         ( area.top() - m_tilesRect.top() ) / pixelSize,
+                         area.width() / pixelSize,
+                         area.height() / pixelSize );
+    painter->drawImage( area, m_overview[ level ], source );
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
@@ -0,0 +1,157 @@
+/* Copyright (c) 2013 by William Hallatt.
+ *
+ * This file forms part of "AntSim".
+ *
+ * The official website for this project is <http://www.goblincoding.com> and,
+ * although not compulsory, it would be appreciated if all works of whatever
+ * nature using this source code (in whole or in part) include a reference to
+ * this site.
+ *
+ * Should you wish to contact me for whatever reason, please do so via:
+ *
+ *                 <http://www.goblincoding.com/contact>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program (GNUGPL.txt).  If not, see
+ *
+ *                    <http://www.gnu.org/licenses/>
+ */
+
+#ifndef GRAPHICSTERRAINITEM_H
+#define GRAPHICSTERRAINITEM_H
+
+#include <QGraphicsItem>
+#include <QHash>
+#include <QImage>
+#include <QPair>
+#include <QPixmap>
+
+#include <vector>
+
+/*--------------------------------------------------------------------------------------*/
+
+class GraphicsWorldTile;
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief A single scene item drawing all the world tiles.
+ *
+ *  The tile grid is split into square chunks of ChunkTiles x ChunkTiles tiles, each drawn
+ *  into a pixmap of its own the first time it is exposed.  After that, painting is a matter
+ *  of copying the exposed chunks' pixmaps and changing a tile's type only redraws that tile
+ *  in its chunk's pixmap.  Finding the tile under a point is a lookup in its chunk's grid.
+ *  Pixmaps are kept for at most MaxCachedChunks chunks (more only while that many are
+ *  exposed at once), the pixmaps of the chunks drawn least recently are freed beyond that
+ *  and redrawn when they are exposed again, so panning across a large world doesn't keep
+ *  all of it in memory at scene resolution.
+ *
+ *  Below the detail threshold scale, tiles become too small to make out and the item draws
+ *  an overview instead.  The overview is a mip chain: one pixel per tile at level 0 and each
+ *  further level halving the one before it (built once, then kept up to date pixel by pixel).
+ *  Only the exposed part of the level whose pixels are closest to screen pixels is drawn, so
+ *  the cost of a frame is bounded by the size of the view rather than that of the world.
+ *
+ *  All tiles are expected to be AntConfig::TileSize squares on a grid anchored at the first
+ *  tile added.
+ */
+
+class GraphicsTerrainItem : public QGraphicsItem
+{
+public:
+  /*! The number of tiles along each side of a chunk. */
+  static const int ChunkTiles = 32;
+
+  /*! The number of chunk pixmaps kept (about 1.6 MB each). */
+  static const int MaxCachedChunks = 48;
+
+  /*! Constructor. */
+  explicit GraphicsTerrainItem( QGraphicsItem* parent = 0 );
+
+  /*! Adds "tile" (if it hasn't been added yet) and redraws it (called by the tile whenever its
+   *  type changes). */
+  void updateTile( GraphicsWorldTile* tile );
+
+  /*! Returns the tile at "point" or nullptr if there is none. */
+  GraphicsWorldTile* tileAt( const QPointF& point ) const;
+
+  /*! Returns the area covered by the tiles. */
+  const QRectF& tilesRect() const;
+
+  /*! Sets the view scale below which the overview is drawn instead of the tiles (default
+   *  AntConfig::DetailScale). */
+  void setDetailThreshold( qreal scale );
+
+  /*! Re-implemented from QGraphicsItem. */
+  QRectF boundingRect() const;
+
+  /*! Re-implemented from QGraphicsItem. */
+  void paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget );
+
+private:
+  /*! A ChunkTiles x ChunkTiles square of the grid. */
+  struct Chunk
+  {
+    QRectF rect;
+    std::vector< GraphicsWorldTile* > tiles;    // row major, nullptr where there is no tile
+    QPixmap pixmap;
+    bool dirty;                                 // the pixmap has to be redrawn completely (or was freed)
+    int lastDrawn;                              // the paint in which the pixmap was last drawn
+  };
+
+  /*! Calculates the grid ( "row", "column" ) of "point". */
+  void gridCoordinates( const QPointF& point, int& row, int& column ) const;
+
+  /*! Returns the key of the chunk holding grid ( "row", "column" ). */
+  static QPair< int, int > chunkKey( int row, int column );
+
+  /*! Returns the index of grid ( "row", "column" ) into its chunk's tiles. */
+  static int chunkIndex( int row, int column );
+
+  /*! Redraws the whole of "chunk" into its pixmap. */
+  static void drawChunk( Chunk& chunk );
+
+  /*! Frees the pixmaps of the chunks drawn least recently (but not during the current paint)
+   *  until no more than MaxCachedChunks are left. */
+  void freeChunks();
+
+  /*! Draws "tile" with "painter" (which must be translated to its chunk's origin). */
+  static void drawTile( QPainter& painter, const GraphicsWorldTile& tile );
+
+  /*! Sets the level 0 overview pixel of "tile" to the tile's colour and updates the pixels
+   *  covering it on the other levels. */
+  void drawOverviewTile( const GraphicsWorldTile& tile );
+
+  /*! Rebuilds all the overview levels from the tiles. */
+  void buildOverview();
+
+  /*! Sets pixel ( "x", "y" ) of overview "level" (> 0) to the average of the pixels it covers
+   *  on the level below. */
+  void downsampleOverview( int level, int x, int y );
+
+  /*! Draws the "exposed" part of the overview at "scale" with "painter" (rebuilding the
+   *  overview first if it is out of date). */
+  void drawOverview( QPainter* painter, const QRectF& exposed, qreal scale );
+
+private:
+  QHash< QPair< int, int >, Chunk > m_chunks;
+  int m_cachedChunks;                           // chunks with a pixmap
+  int m_paints;                                 // the number of calls to paint so far
+  QPointF m_origin;                             // the top left of grid ( 0, 0 )
+  QRectF m_tilesRect;
+  QRectF m_bounds;
+
+  qreal m_detailThreshold;
+  std::vector< QImage > m_overview;             // level 0 has one pixel per tile in m_tilesRect
+  bool m_overviewStale;                         // m_overview has to be rebuilt completely
+};
+
+#endif // GRAPHICSTERRAINITEM_H
@@ -27,17 +27,16 @@
  */
 
 #include "graphicsworldtile.h"
-#include "graphicspheromoneitem.h"
+#include "graphicsterrainitem.h"
 
-#include <QBrush>
-#include <QPen>
 #include <QDomDocument>
 
 /*--------------------------------------------------------------------------------------*/
 
-GraphicsWorldTile::GraphicsWorldTile( const AntPosition& position, TileType type, QGraphicsItem* parent )
-: AntWorldTile     (),
-  QGraphicsRectItem( parent )
+GraphicsWorldTile::GraphicsWorldTile( const AntPosition& position, TileType type, const QRectF& rect, GraphicsTerrainItem* terrain )
+: AntWorldTile(),
+  m_rect      ( rect ),
+  m_terrain   ( terrain )
 {
   setCentre( position );
   setTileType( type );
@@ -45,47 +44,57 @@ GraphicsWorldTile::GraphicsWorldTile( const AntPosition& position, TileType type
 
 /*--------------------------------------------------------------------------------------*/
 
-QDomElement GraphicsWorldTile::serialise()
+const QRectF& GraphicsWorldTile::rect() const
 {
-  QDomDocument doc;
-  QDomElement element = doc.createElement( "GraphicsWorldTile" );
-  element.setAttribute( "x", rect().x() );
-  element.setAttribute( "y", rect().y() );
-  element.setAttribute( "width", rect().width() );
-  element.setAttribute( "height", rect().height() );
-  element.setAttribute( "type", static_cast< int >( tileType() ) );
-  return element.cloneNode().toElement();
+  return m_rect;
 }
 
 /*--------------------------------------------------------------------------------------*/
 
-void GraphicsWorldTile::updateGraphics( AntWorldTile::TileType type )
+QString GraphicsWorldTile::toolTip() const
 {
-  switch( type )
+  switch( tileType() )
   {
     case Path:
-      setBrush( Qt::white );
-      setToolTip( "This is a \"path\" tile." );
-      break;
+      return "This is a \"path\" tile.";
     case Wall:
-      setBrush( Qt::darkBlue );
-      setToolTip( "This is a \"wall\" tile." );
-      break;
+      return "This is a \"wall\" tile.";
     case Hazard:
-      setBrush( Qt::darkRed );
-      setToolTip( "This is a \"hazard\" tile." );
-      break;
+      return "This is a \"hazard\" tile.";
     case Food:
-      setBrush( Qt::darkGreen );
-      setToolTip( "This is a \"food\" tile." );
-      break;
+      return "This is a \"food\" tile.";
     case Spawn:
-      setBrush( Qt::darkMagenta );
-      setToolTip( "This is a spawn point." );
-      break;
+      return "This is a spawn point.";
+    case None:
     default:
-      return;   // if type is NONE, do no nothing
+      return QString();
+  }
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+QDomElement GraphicsWorldTile::serialise()
+{
+  QDomDocument doc;
+  QDomElement element = doc.createElement( "GraphicsWorldTile" );
+  element.setAttribute( "x", m_rect.x() );
+  element.setAttribute( "y", m_rect.y() );
+  element.setAttribute( "width", m_rect.width() );
+  element.setAttribute( "height", m_rect.height() );
+  element.setAttribute( "type", static_cast< int >( tileType() ) );
+  return element.cloneNode().toElement();
+}
+
+/*--------------------------------------------------------------------------------------*/
+
+void GraphicsWorldTile::updateGraphics( AntWorldTile::TileType type )
+{
+  if( type == None )
+  {
+    return;   // if type is NONE, do no nothing (the tile keeps its current look)
   }
+
+  m_terrain->updateTile( this );
 }
 
-/*--------------------------------------------------------------------------------------*/
\ No newline at end of file
+/*--------------------------------------------------------------------------------------*/
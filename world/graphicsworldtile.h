@@ -31,18 +31,34 @@
 
 #include "ants/antworldtile.h"
 
-#include <QGraphicsRectItem>
+#include <QRectF>
+#include <QString>
 #include <QDomElement>
 
-/*! \brief This class inherits from AntWorldTile and is responsible for the graphical aspects of the tiles. */
+/*--------------------------------------------------------------------------------------*/
 
-class GraphicsWorldTile : public AntWorldTile,
-                          public QGraphicsRectItem
+class GraphicsTerrainItem;
+
+/*--------------------------------------------------------------------------------------*/
+
+/*! \brief This class inherits from AntWorldTile and is responsible for the graphical aspects of the tiles.
+ *
+ *  Tiles aren't scene items of their own, they are drawn by the GraphicsTerrainItem they are
+ *  added to (which is told to redraw a tile whenever its type changes).
+ */
+
+class GraphicsWorldTile : public AntWorldTile
 {
 public:
 
-  /*! Constructor. */
-  explicit GraphicsWorldTile( const AntPosition& position, TileType type, QGraphicsItem* parent = 0 );
+  /*! Constructor, adds the tile to "terrain" (which must outlive it). */
+  explicit GraphicsWorldTile( const AntPosition& position, TileType type, const QRectF& rect, GraphicsTerrainItem* terrain );
+
+  /*! Returns the area of the scene covered by the tile. */
+  const QRectF& rect() const;
+
+  /*! Returns the text shown when hovering over the tile (empty for "None"). */
+  QString toolTip() const;
 
   /*! Serialises the tile data (width, length and coordinates) and returns it as a well-formed XML DOM element. */
   QDomElement serialise();
@@ -50,6 +66,10 @@ public:
 protected:
   /*! Re-implemented from AntWorldTile. */
   virtual void updateGraphics( TileType type );
+
+private:
+  QRectF m_rect;
+  GraphicsTerrainItem* m_terrain;
 };
 
 #endif // GRAPHICSWORLDTILE_H